@@ -2,12 +2,23 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
 #include <vector>
+#include <memory>
+#include <queue>
+#include <deque>
 #include <cstdlib>
 #include <ctime>
 #include <chrono>
 #include <atomic>
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <fstream>
+#include <cmath>
+#include <sstream>
+#include "varredura.h"
 
 using namespace std;
 
@@ -17,164 +28,1083 @@ enum EstadoCliente { ENTRA, AGUARDA, DESISTE, ATENDIDO };
 struct Cliente {
     int id;
     EstadoCliente estado;
+    // Instantes em microssegundos desde o início da simulação
+    long long chegada;
+    long long inicioAtendimento;
+    long long saida;
 };
 
+// Histograma com baldes logarítmicos: valores abaixo de SUBBALDES ficam em
+// baldes exatos; acima, cada potência de 2 é dividida em SUBBALDES faixas
+// lineares (erro relativo < 1/SUBBALDES, ~3%). Registrar custa poucas
+// instruções e nenhuma sincronização: cada thread tem os seus e eles são
+// somados no fim.
+class Histograma {
+public:
+    static const int BITS_SUB = 5;
+    static const int SUBBALDES = 1 << BITS_SUB;
+    static const int NUM_BALDES = (64 - BITS_SUB + 1) * SUBBALDES;
+
+    Histograma() : contagem(0), soma(0), maximo(0) { baldes.fill(0); }
+
+    void registrar(uint64_t valor) {
+        baldes[indice(valor)]++;
+        contagem++;
+        soma += valor;
+        if (valor > maximo) maximo = valor;
+    }
+
+    void juntar(const Histograma& outro) {
+        for (int i = 0; i < NUM_BALDES; i++) baldes[i] += outro.baldes[i];
+        contagem += outro.contagem;
+        soma += outro.soma;
+        maximo = max(maximo, outro.maximo);
+    }
+
+    // Limite superior do balde que contém o percentil p (0-100)
+    uint64_t percentil(double p) const {
+        if (contagem == 0) return 0;
+        uint64_t posicao = (uint64_t)(p / 100.0 * contagem + 0.5);
+        if (posicao == 0) posicao = 1;
+        uint64_t acumulado = 0;
+        for (int i = 0; i < NUM_BALDES; i++) {
+            acumulado += baldes[i];
+            if (acumulado >= posicao) return min(limiteSuperior(i), maximo);
+        }
+        return maximo;
+    }
+
+    uint64_t total() const { return contagem; }
+    uint64_t maior() const { return maximo; }
+    double media() const { return contagem ? (double)soma / contagem : 0; }
+
+private:
+    static int bitMaisAlto(uint64_t v) {
+#if defined(__GNUC__)
+        return 63 - __builtin_clzll(v);
+#else
+        int bit = 0;
+        while (v >>= 1) bit++;
+        return bit;
+#endif
+    }
+
+    static int indice(uint64_t v) {
+        if (v < (uint64_t)SUBBALDES) return (int)v;
+        int deslocamento = bitMaisAlto(v) - BITS_SUB;
+        return (deslocamento + 1) * SUBBALDES + (int)((v >> deslocamento) & (SUBBALDES - 1));
+    }
+
+    static uint64_t limiteSuperior(int i) {
+        if (i < SUBBALDES) return i;
+        int deslocamento = i / SUBBALDES - 1;
+        return (((uint64_t)(SUBBALDES + i % SUBBALDES) + 1) << deslocamento) - 1;
+    }
+
+    array<uint64_t, NUM_BALDES> baldes;
+    uint64_t contagem;
+    uint64_t soma;
+    uint64_t maximo;
+};
+
+// Fila circular limitada sem bloqueio para vários produtores e consumidores
+// (algoritmo de Dmitry Vyukov). Cada posição guarda um número de sequência:
+// igual à posição de inserção quando está livre para o produtor daquela volta,
+// e posição + 1 quando já tem valor para o consumidor. Produtores e consumidores
+// só disputam o próprio índice (compare_exchange), nunca um mutex.
+// O anel tem pelo menos 2 posições: com 1 só, "preenchida na volta p" e
+// "livre para a volta p + 1" teriam o mesmo número de sequência.
+template <typename T>
+class FilaMPMC {
+public:
+    explicit FilaMPMC(size_t capacidade)
+        : capacidadeFila(capacidade), tamanhoAnel(max(capacidade, (size_t)2)),
+          celulas(new Celula[max(capacidade, (size_t)2)]), posInsercao(0), posRemocao(0) {
+        for (size_t i = 0; i < tamanhoAnel; i++) {
+            celulas[i].sequencia.store(i, memory_order_relaxed);
+        }
+    }
+
+    // Retorna false se a fila estiver cheia
+    bool tentaInserir(const T& valor) {
+        if (capacidadeFila == 0) return false;
+        size_t pos = posInsercao.load(memory_order_relaxed);
+        for (;;) {
+            // Com uma cadeira o anel tem 2 posições: a segunda só pode ser usada
+            // depois que a primeira foi retirada
+            if (capacidadeFila < tamanhoAnel && pos - posRemocao.load(memory_order_acquire) >= capacidadeFila) {
+                return false;
+            }
+            Celula& celula = celulas[pos % tamanhoAnel];
+            size_t seq = celula.sequencia.load(memory_order_acquire);
+            intptr_t diferenca = (intptr_t)seq - (intptr_t)pos;
+            if (diferenca == 0) {
+                if (posInsercao.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    celula.valor = valor;
+                    celula.sequencia.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            } else if (diferenca < 0) {
+                return false;   // Posição ainda ocupada pela volta anterior: cheia
+            } else {
+                pos = posInsercao.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Retorna false se a fila estiver vazia
+    bool tentaRemover(T& valor) {
+        if (capacidadeFila == 0) return false;
+        size_t pos = posRemocao.load(memory_order_relaxed);
+        for (;;) {
+            Celula& celula = celulas[pos % tamanhoAnel];
+            size_t seq = celula.sequencia.load(memory_order_acquire);
+            intptr_t diferenca = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diferenca == 0) {
+                if (posRemocao.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    valor = celula.valor;
+                    // Libera a posição para o produtor da próxima volta
+                    celula.sequencia.store(pos + tamanhoAnel, memory_order_release);
+                    return true;
+                }
+            } else if (diferenca < 0) {
+                return false;   // Nada publicado nesta posição: vazia
+            } else {
+                pos = posRemocao.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Ocupação aproximada (os índices podem mudar durante a leitura)
+    size_t tamanho() const {
+        size_t removidos = posRemocao.load(memory_order_relaxed);
+        size_t inseridos = posInsercao.load(memory_order_relaxed);
+        return inseridos > removidos ? min(inseridos - removidos, capacidadeFila) : 0;
+    }
+
+private:
+    struct Celula {
+        atomic<size_t> sequencia;
+        T valor;
+    };
+
+    const size_t capacidadeFila;
+    const size_t tamanhoAnel;
+    unique_ptr<Celula[]> celulas;
+    // Índices em linhas de cache separadas: produtores e consumidores não se atrapalham
+    atomic<size_t> posInsercao;
+    char separador[64];
+    atomic<size_t> posRemocao;
+};
+
+// Seqlock de um único escritor: a thread dona publica seus contadores sem
+// bloquear (a versão fica ímpar durante a escrita) e o leitor repete a
+// leitura até obter uma cópia que não mudou no meio. Os campos são atômicos
+// relaxados para que a leitura concorrente não seja uma condição de corrida.
+template <int N>
+class Instantaneo {
+public:
+    Instantaneo() : versao(0) {
+        for (int i = 0; i < N; i++) campos[i].store(0, memory_order_relaxed);
+    }
+
+    void publicar(const long long (&valores)[N]) {
+        unsigned v = versao.load(memory_order_relaxed);
+        versao.store(v + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        for (int i = 0; i < N; i++) campos[i].store(valores[i], memory_order_relaxed);
+        versao.store(v + 2, memory_order_release);
+    }
+
+    void ler(long long (&valores)[N]) const {
+        for (;;) {
+            unsigned antes = versao.load(memory_order_acquire);
+            if (antes & 1) {
+                this_thread::yield();
+                continue;
+            }
+            for (int i = 0; i < N; i++) valores[i] = campos[i].load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            if (versao.load(memory_order_relaxed) == antes) return;
+        }
+    }
+
+private:
+    atomic<unsigned> versao;
+    atomic<long long> campos[N];
+};
+
+// Campos publicados por cada barbeiro e pelo gerador
+enum { PUB_ESTADO, PUB_ATENDIDOS, PUB_RETIRADOS };
+enum { PUB_CHEGARAM, PUB_DESISTENTES, PUB_INSERIDOS };
+
+// Estado de cada barbeiro; o preenchimento evita que contadores de
+// barbeiros diferentes dividam a mesma linha de cache
+struct Barbeiro {
+    atomic<EstadoBarbeiro> estado;
+    atomic<int> atendidos;
+    char preenchimento[64];
+    Instantaneo<3> publicado;           // estado, atendidos, retirados da fila (monitor)
+    // Escritos só pela thread do próprio barbeiro; lidos depois do join
+    Histograma espera;                  // chegada -> início do atendimento (us)
+    Histograma atendimento;             // início -> fim do atendimento (us)
+    Histograma noSistema;               // chegada -> saída (us)
+    long long tempoOcupado = 0;         // us atendendo
+    vector<long long> esperaPorSegundo; // us de espera em fila dentro de cada segundo
+};
+
+// Distribuição dos intervalos sorteados a partir de um intervalo [min, max] ms:
+// uniforme no intervalo; exponencial (chegadas de Poisson) e determinística
+// com a média do intervalo
+enum Distribuicao { UNIFORME, EXPONENCIAL, DETERMINISTICA };
+
 // Parâmetros globais
 int numCadeiras;
+int numBarbeiros;
 int taxaChegadaMin, taxaChegadaMax;  // tempo entre chegadas (ms)
 int tempoAtendimentoMin, tempoAtendimentoMax;  // tempo de atendimento (ms)
 int duracaoSimulacao;  // em segundos
+Distribuicao distChegada = UNIFORME;
+Distribuicao distAtendimento = UNIFORME;
+vector<long long> chegadasTrace;  // instantes de chegada lidos de arquivo (us); vazio = sorteados
+unsigned sementeBase = 1;
 
 // Estado da barbearia
-EstadoBarbeiro estadoBarbeiro = DORME;
-queue<Cliente> filaEspera;
+unique_ptr<Barbeiro[]> barbeiros;
+unique_ptr<FilaMPMC<Cliente>> filaEspera;
 atomic<int> proximoClienteId(1);
 atomic<bool> rodando(true);
 
-// Contadores
-atomic<int> clientesAtendidos(0);
+// Contadores (atendidos fica em cada Barbeiro)
 atomic<int> clientesDesistentes(0);
 atomic<int> totalClientesChegaram(0);
+int filaMaxima = 0;  // maior ocupação vista pelo gerador
+vector<long long> esperaNaoAtendidos;  // como esperaPorSegundo, para quem ainda estava na fila no fim
+Instantaneo<3> publicadoGerador;  // chegaram, desistentes, inseridos na fila (monitor)
+
+// Monitor: intervalo entre amostras e série temporal opcional em CSV
+int intervaloMonitorMs = 1000;
+ofstream serieCsv;
 
-// Sincronização
-mutex mutexFila;
+chrono::steady_clock::time_point inicioSimulacao;
+
+// Sincronização: a fila não usa mutex; ele só protege o sono dos barbeiros
+mutex mutexSono;
+atomic<int> barbeirosDormindo(0);
 condition_variable cvBarbeiro;  // para acordar o barbeiro
 condition_variable cvCliente;   // para clientes esperarem
 
-// Função auxiliar para gerar tempo aleatório
-int tempoAleatorio(int min, int max) {
-    return min + rand() % (max - min + 1);
+// Gerador próprio de cada thread: sem o lock interno do rand() e com
+// sequência reprodutível para a mesma semente
+thread_local mt19937_64 gerador;
+
+// Semeia o gerador da thread atual (0 = gerador de clientes / modo virtual,
+// 1..N = barbeiros) a partir da semente da execução
+void semearThread(unsigned indice) {
+    seed_seq sequencia{sementeBase, indice};
+    gerador.seed(sequencia);
+}
+
+// Sorteia uma duração em microssegundos
+long long tempoAleatorioUs(Distribuicao dist, int min, int max) {
+    double media = (min + max) * 500.0;
+    switch (dist) {
+        case DETERMINISTICA:
+            return llround(media);
+        case EXPONENCIAL: {
+            if (media <= 0) return 0;
+            exponential_distribution<double> exponencial(1.0 / media);
+            return llround(exponencial(gerador));
+        }
+        default: {
+            uniform_int_distribution<long long> uniforme(min * 1000LL, max * 1000LL);
+            return uniforme(gerador);
+        }
+    }
+}
+
+long long sortearChegadaUs() { return tempoAleatorioUs(distChegada, taxaChegadaMin, taxaChegadaMax); }
+long long sortearAtendimentoUs() { return tempoAleatorioUs(distAtendimento, tempoAtendimentoMin, tempoAtendimentoMax); }
+
+// Lê instantes de chegada (ms desde o início, um por linha, # = comentário)
+bool lerChegadas(const string& caminho) {
+    ifstream arquivo(caminho);
+    if (!arquivo.is_open()) {
+        cerr << "Erro: Nao foi possivel abrir " << caminho << endl;
+        return false;
+    }
+    string linha;
+    while (getline(arquivo, linha)) {
+        size_t comentario = linha.find('#');
+        if (comentario != string::npos) linha.erase(comentario);
+        if (aparar(linha).empty()) continue;
+        chegadasTrace.push_back(llround(atof(linha.c_str()) * 1000.0));
+    }
+    sort(chegadasTrace.begin(), chegadasTrace.end());
+    return true;
+}
+
+Distribuicao lerDistribuicao(const string& nome) {
+    if (nome == "exponencial" || nome == "poisson") return EXPONENCIAL;
+    if (nome == "deterministica") return DETERMINISTICA;
+    return UNIFORME;
+}
+
+// Microssegundos desde o início da simulação (modo com threads)
+long long agoraUs() {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - inicioSimulacao).count();
+}
+
+// Tamanho da fila ao longo do tempo: a espera de cada cliente é somada
+// aos segundos em que ele ficou na fila (média por segundo = soma / 1 s).
+// Só conta o que cai dentro da duração da simulação
+void registrarEspera(vector<long long>& esperaPorSegundo, long long de, long long ate) {
+    ate = min(ate, duracaoSimulacao * 1000000LL);
+    for (long long seg = de / 1000000; seg <= ate / 1000000 && seg < (long long)esperaPorSegundo.size(); seg++) {
+        long long ini = max(de, seg * 1000000), fim = min(ate, (seg + 1) * 1000000);
+        if (fim > ini) esperaPorSegundo[seg] += fim - ini;
+    }
+}
+
+// Registra um atendimento concluído nas estatísticas do barbeiro
+void registrarAtendimento(Barbeiro& b, const Cliente& c) {
+    b.espera.registrar(c.inicioAtendimento - c.chegada);
+    b.atendimento.registrar(c.saida - c.inicioAtendimento);
+    b.noSistema.registrar(c.saida - c.chegada);
+    b.tempoOcupado += c.saida - c.inicioAtendimento;
+    registrarEspera(b.esperaPorSegundo, c.chegada, c.inicioAtendimento);
+}
+
+// Clientes que ainda estavam na fila no fim da simulação: não entram nas
+// latências, mas esperaram até o fim e contam no tamanho médio da fila
+void registrarNaoAtendido(const Cliente& c) {
+    registrarEspera(esperaNaoAtendidos, c.chegada, duracaoSimulacao * 1000000LL);
 }
 
 // Thread do barbeiro
-void barbeiro() {
+void barbeiro(int id) {
+    Barbeiro& eu = barbeiros[id];
+    Cliente cliente;
+    semearThread(id + 1);
+    long long atendidos = 0, retirados = 0;
+
     while (rodando) {
-        unique_lock<mutex> lock(mutexFila);
-        
         // Se não há clientes, barbeiro dorme
-        if (filaEspera.empty()) {
-            estadoBarbeiro = DORME;
-            cvBarbeiro.wait(lock, [&] { return !filaEspera.empty() || !rodando; });
+        if (!filaEspera->tentaRemover(cliente)) {
+            eu.estado = DORME;
+            eu.publicado.publicar({DORME, atendidos, retirados});
+            unique_lock<mutex> lock(mutexSono);
+            barbeirosDormindo++;
+            // Pareia com a barreira do gerador: ou ele vê o barbeiro dormindo,
+            // ou o barbeiro vê o cliente recém-inserido
+            atomic_thread_fence(memory_order_seq_cst);
+            bool temCliente = false;
+            cvBarbeiro.wait(lock, [&] {
+                temCliente = filaEspera->tentaRemover(cliente);
+                return temCliente || !rodando;
+            });
+            barbeirosDormindo--;
+            if (!temCliente) break;
         }
         
-        if (!rodando) break;
+        // Barbeiro acorda e atende cliente (sem segurar nenhum lock). Um
+        // cliente retirado da fila é atendido mesmo que o tempo tenha acabado
+        // nesse meio-tempo, como quem já estava na cadeira
+        eu.estado = ATENDE;
+        eu.publicado.publicar({ATENDE, atendidos, ++retirados});
+        cliente.inicioAtendimento = agoraUs();
         
-        // Barbeiro acorda e atende cliente
-        if (!filaEspera.empty()) {
-            estadoBarbeiro = ATENDE;
-            Cliente cliente = filaEspera.front();
-            filaEspera.pop();
-            
-            lock.unlock();  // Libera o mutex enquanto atende
-            
-            // Simula tempo de atendimento
-            this_thread::sleep_for(chrono::milliseconds(
-                tempoAleatorio(tempoAtendimentoMin, tempoAtendimentoMax)
-            ));
-            
-            clientesAtendidos++;
-        }
+        // Simula tempo de atendimento
+        this_thread::sleep_for(chrono::microseconds(sortearAtendimentoUs()));
+        
+        cliente.saida = agoraUs();
+        cliente.estado = ATENDIDO;
+        registrarAtendimento(eu, cliente);
+        eu.atendidos.fetch_add(1, memory_order_relaxed);
+        eu.publicado.publicar({ATENDE, ++atendidos, retirados});
+    }
+}
+
+// Soma os atendimentos de todos os barbeiros
+int totalAtendidos() {
+    int total = 0;
+    for (int i = 0; i < numBarbeiros; i++) {
+        total += barbeiros[i].atendidos.load(memory_order_relaxed);
     }
+    return total;
 }
 
 // Thread geradora de clientes
 void gerarClientes() {
+    semearThread(0);
+    size_t proximaTrace = 0;
+    long long chegaram = 0, desistentes = 0, inseridos = 0;
     while (rodando) {
-        // Aguarda tempo entre chegadas
-        this_thread::sleep_for(chrono::milliseconds(
-            tempoAleatorio(taxaChegadaMin, taxaChegadaMax)
-        ));
+        // Aguarda tempo entre chegadas (ou o próximo instante do arquivo)
+        if (chegadasTrace.empty()) {
+            this_thread::sleep_for(chrono::microseconds(sortearChegadaUs()));
+        } else if (proximaTrace < chegadasTrace.size()) {
+            this_thread::sleep_until(inicioSimulacao + chrono::microseconds(chegadasTrace[proximaTrace++]));
+        } else {
+            break;  // Arquivo de chegadas esgotado
+        }
         
         if (!rodando) break;
         
         // Novo cliente chega
-        Cliente novoCliente = {proximoClienteId++, ENTRA};
+        Cliente novoCliente = {proximoClienteId++, ENTRA, agoraUs(), 0, 0};
         totalClientesChegaram++;
         
-        unique_lock<mutex> lock(mutexFila);
-        
-        // Verifica se há lugar na fila
-        if (filaEspera.size() < numCadeiras) {
-            novoCliente.estado = AGUARDA;
-            filaEspera.push(novoCliente);
-            
-            // Acorda o barbeiro se estiver dormindo
-            cvBarbeiro.notify_one();
+        // Verifica se há lugar na fila (inserção falha com a sala cheia)
+        novoCliente.estado = AGUARDA;
+        if (filaEspera->tentaInserir(novoCliente)) {
+            publicadoGerador.publicar({++chegaram, desistentes, ++inseridos});
+            filaMaxima = max(filaMaxima, (int)filaEspera->tamanho());
+            // Acorda um barbeiro se algum estiver dormindo; o mutex só é
+            // tocado quando há quem acordar
+            atomic_thread_fence(memory_order_seq_cst);
+            if (barbeirosDormindo.load() > 0) {
+                lock_guard<mutex> lock(mutexSono);
+                cvBarbeiro.notify_one();
+            }
         } else {
             // Sala lotada - cliente desiste
             novoCliente.estado = DESISTE;
             clientesDesistentes++;
+            publicadoGerador.publicar({++chegaram, ++desistentes, inseridos});
         }
     }
 }
 
-// Thread do monitor (exibe estado)
-void monitor() {
+// Amostra do estado da barbearia montada a partir dos instantâneos
+struct Amostra {
+    long long tempoMs;
+    long long chegaram, atendidos, desistentes, fila;
+    int atendendo;                  // barbeiros ocupados
+    vector<int> estados;
+};
+
+void escreverCabecalhoSerie() {
+    if (serieCsv.is_open()) serieCsv << "tempo_ms,fila,chegaram,atendidos,desistentes,barbeiros_atendendo\n";
+}
+
+void escreverSerie(const Amostra& a) {
+    if (!serieCsv.is_open()) return;
+    serieCsv << a.tempoMs << "," << a.fila << "," << a.chegaram << "," << a.atendidos << ","
+             << a.desistentes << "," << a.atendendo << "\n";
+}
+
+// Lê o instantâneo de cada thread sem bloquear nenhuma delas. Cada
+// instantâneo é consistente, mas as leituras não são simultâneas; o tamanho
+// da fila sai da diferença entre inseridos (gerador) e retirados (barbeiros)
+Amostra coletarAmostra() {
+    Amostra a;
+    a.tempoMs = agoraUs() / 1000;
+    long long gerador[3];
+    publicadoGerador.ler(gerador);
+    a.chegaram = gerador[PUB_CHEGARAM];
+    a.desistentes = gerador[PUB_DESISTENTES];
+    a.atendidos = 0;
+    a.atendendo = 0;
+    long long retirados = 0;
+    for (int i = 0; i < numBarbeiros; i++) {
+        long long barbeiro[3];
+        barbeiros[i].publicado.ler(barbeiro);
+        a.estados.push_back((int)barbeiro[PUB_ESTADO]);
+        a.atendidos += barbeiro[PUB_ATENDIDOS];
+        retirados += barbeiro[PUB_RETIRADOS];
+        if (barbeiro[PUB_ESTADO] == ATENDE) a.atendendo++;
+    }
+    a.fila = max(0LL, min((long long)numCadeiras, gerador[PUB_INSERIDOS] - retirados));
+    return a;
+}
+
+// Thread do monitor (exibe estado e grava a série)
+// Não toma nenhum lock: lê os instantâneos publicados e monta o texto
+// inteiro antes de uma única escrita no cout
+void monitor(bool exibir) {
+    escreverCabecalhoSerie();
+    auto proxima = chrono::steady_clock::now();
     while (rodando) {
-        this_thread::sleep_for(chrono::seconds(1));
+        // Dorme em fatias curtas para encerrar logo mesmo com intervalo longo
+        proxima += chrono::milliseconds(intervaloMonitorMs);
+        for (auto agora = chrono::steady_clock::now(); rodando && agora < proxima; agora = chrono::steady_clock::now()) {
+            this_thread::sleep_for(min<chrono::steady_clock::duration>(proxima - agora, chrono::milliseconds(50)));
+        }
+        if (!rodando) break;
+        
+        Amostra a = coletarAmostra();
+        escreverSerie(a);
+        if (!exibir) continue;
         
-        unique_lock<mutex> lock(mutexFila);
+        ostringstream texto;
         
-        // Estado do barbeiro
-        cout << "Barbeiro: " << (estadoBarbeiro == DORME ? "DORME" : "ATENDE") << endl;
+        // Estado dos barbeiros
+        for (int i = 0; i < numBarbeiros; i++) {
+            texto << "Barbeiro " << i + 1 << ": " << (a.estados[i] == DORME ? "DORME" : "ATENDE") << "\n";
+        }
         
         // Estado da fila
-        cout << "Fila [";
+        texto << "Fila [";
         for (int i = 0; i < numCadeiras; i++) {
-            if (i < filaEspera.size()) {
-                cout << "#";
-            } else {
-                cout << ".";
-            }
+            texto << (i < a.fila ? "#" : ".");
         }
-        cout << "] (" << filaEspera.size() << "/" << numCadeiras << ")" << endl;
+        texto << "] (" << a.fila << "/" << numCadeiras << ")\n";
         
         // Contadores
-        cout << "Atendidos: " << clientesAtendidos << " | ";
-        cout << "Desistentes: " << clientesDesistentes << " | ";
-        cout << "Em espera: " << filaEspera.size() << " | ";
-        cout << "Total chegaram: " << totalClientesChegaram << endl;
-        cout << "----------------------------------------" << endl;
+        texto << "Atendidos: " << a.atendidos << " | ";
+        texto << "Desistentes: " << a.desistentes << " | ";
+        texto << "Em espera: " << a.fila << " | ";
+        texto << "Total chegaram: " << a.chegaram << "\n";
+        texto << "----------------------------------------\n";
         
-        lock.unlock();
+        string saida = texto.str();
+        cout.write(saida.data(), saida.size());
+        cout.flush();
+    }
+}
+
+void imprimirResumo();
+void imprimirLatencias();
+void imprimirCsv();
+
+// Simulação por eventos discretos em tempo virtual: sem threads nem sleep,
+// o relógio salta direto para o próximo evento da fila de prioridade.
+// Mesmas regras do modo com threads: o cliente só entra se houver cadeira
+// livre e um barbeiro livre o tira da fila na mesma hora.
+enum TipoEvento { CHEGADA, FIM_ATENDIMENTO };
+
+struct Evento {
+    long long tempo;   // us virtuais desde o início
+    long long ordem;   // desempate: eventos no mesmo instante saem na ordem de criação
+    TipoEvento tipo;
+    int barbeiro;
+    Cliente cliente;   // FIM_ATENDIMENTO: cliente atendido
+};
+
+struct EventoPosterior {
+    template <class E>
+    bool operator()(const E& a, const E& b) const {
+        return a.tempo != b.tempo ? a.tempo > b.tempo : a.ordem > b.ordem;
+    }
+};
+
+long long simularTempoVirtual() {
+    priority_queue<Evento, vector<Evento>, EventoPosterior> eventos;
+    deque<Cliente> fila;
+    vector<int> barbeirosLivres;
+    for (int i = numBarbeiros - 1; i >= 0; i--) barbeirosLivres.push_back(i);
+
+    long long fim = duracaoSimulacao * 1000000LL;
+    size_t proximaTrace = 0;
+    semearThread(0);
+
+    // Próxima chegada depois de "agora" (-1 quando o arquivo de chegadas acabou)
+    auto proximaChegada = [&](long long agora) -> long long {
+        if (chegadasTrace.empty()) return agora + sortearChegadaUs();
+        return proximaTrace < chegadasTrace.size() ? chegadasTrace[proximaTrace++] : -1;
+    };
+    long long ordem = 0;
+    long long processados = 0;
+
+    auto iniciarAtendimento = [&](long long agora) {
+        while (!fila.empty() && !barbeirosLivres.empty()) {
+            int b = barbeirosLivres.back();
+            barbeirosLivres.pop_back();
+            Cliente cliente = fila.front();
+            fila.pop_front();
+            cliente.inicioAtendimento = agora;
+            barbeiros[b].estado = ATENDE;
+            long long duracao = sortearAtendimentoUs();
+            eventos.push({agora + duracao, ordem++, FIM_ATENDIMENTO, b, cliente});
+        }
+    };
+
+    // Série temporal: amostra nos instantes virtuais múltiplos do intervalo
+    long long proximaAmostra = intervaloMonitorMs * 1000LL;
+    long long atendidosVirtual = 0;
+    escreverCabecalhoSerie();
+
+    long long primeira = proximaChegada(0);
+    if (primeira >= 0) eventos.push({primeira, ordem++, CHEGADA, -1, Cliente()});
+    while (!eventos.empty() && eventos.top().tempo <= fim) {
+        Evento e = eventos.top();
+        eventos.pop();
+        processados++;
+
+        while (serieCsv.is_open() && proximaAmostra <= e.tempo) {
+            int atendendo = numBarbeiros - (int)barbeirosLivres.size();
+            escreverSerie({proximaAmostra / 1000, totalClientesChegaram, atendidosVirtual, clientesDesistentes,
+                           (long long)fila.size(), atendendo, vector<int>()});
+            proximaAmostra += intervaloMonitorMs * 1000LL;
+        }
+
+        if (e.tipo == CHEGADA) {
+            Cliente novoCliente = {proximoClienteId++, ENTRA, e.tempo, 0, 0};
+            totalClientesChegaram++;
+            if ((int)fila.size() < numCadeiras) {
+                novoCliente.estado = AGUARDA;
+                fila.push_back(novoCliente);
+                filaMaxima = max(filaMaxima, (int)fila.size());
+            } else {
+                novoCliente.estado = DESISTE;
+                clientesDesistentes++;
+            }
+            long long seguinte = proximaChegada(e.tempo);
+            if (seguinte >= 0) eventos.push({seguinte, ordem++, CHEGADA, -1, Cliente()});
+        } else {
+            e.cliente.saida = e.tempo;
+            e.cliente.estado = ATENDIDO;
+            registrarAtendimento(barbeiros[e.barbeiro], e.cliente);
+            barbeiros[e.barbeiro].atendidos++;
+            atendidosVirtual++;
+            barbeiros[e.barbeiro].estado = DORME;
+            barbeirosLivres.push_back(e.barbeiro);
+        }
+        iniciarAtendimento(e.tempo);
     }
+
+    // No fim: a espera de quem está sendo atendido já terminou, mas o
+    // atendimento não (não entra nas latências); a fila esperou até o fim
+    for (; !eventos.empty(); eventos.pop()) {
+        const Evento& e = eventos.top();
+        if (e.tipo == FIM_ATENDIMENTO) {
+            registrarEspera(barbeiros[e.barbeiro].esperaPorSegundo, e.cliente.chegada, e.cliente.inicioAtendimento);
+        }
+    }
+    for (const Cliente& c : fila) registrarNaoAtendido(c);
+    return processados;
 }
 
-int main() {
-    // Inicializa gerador de números aleatórios
-    srand(time(nullptr));
+// ---------------------------------------------------------------------------
+// Várias lojas (sempre em tempo virtual): cada loja tem numBarbeiros e
+// numCadeiras; o cliente que chega é encaminhado por uma política de
+// roteamento e, como na loja única, só entra se houver cadeira livre na loja
+// escolhida. Com roubo, barbeiros parados atendem clientes de outras lojas.
+// Chegadas e atendimentos são sorteados na chegada, na mesma ordem para todas
+// as políticas (números aleatórios comuns); o roteamento tem gerador próprio.
+// ---------------------------------------------------------------------------
+
+enum Roteamento { ALEATORIO, MENOR_FILA, DUAS_ESCOLHAS };
+const char* NOMES_ROTEAMENTO[] = {"aleatorio", "jsq", "dois"};
+
+int numLojas = 1;
+
+struct ClienteLoja {
+    Cliente cliente;
+    int loja;              // loja escolhida na chegada
+    long long duracao;     // atendimento sorteado na chegada (us)
+};
+
+struct EventoLoja {
+    long long tempo;
+    long long ordem;
+    TipoEvento tipo;
+    int loja;              // FIM_ATENDIMENTO: loja do barbeiro que atendeu
+    ClienteLoja cliente;
+};
+
+struct Loja {
+    deque<ClienteLoja> fila;
+    int livres = 0;                     // barbeiros parados
+    long long chegaram = 0, desistentes = 0;
+    long long atendidos = 0, roubados = 0;  // atendidos pelos barbeiros da loja (roubados: de outra loja)
+    long long ocupado = 0;              // us atendendo, somando os barbeiros
+    long long areaFila = 0;             // integral do tamanho da fila (clientes * us)
+    long long ultimaMudanca = 0;
+    int filaMaxima = 0;
+    Histograma espera, noSistema;       // clientes que escolheram esta loja
+
+    void acumularFila(long long agora) {
+        areaFila += (long long)fila.size() * (agora - ultimaMudanca);
+        ultimaMudanca = agora;
+    }
+};
+
+struct ResultadoLojas {
+    Roteamento roteamento;
+    bool roubo;
+    long long eventos;
+    vector<Loja> lojas;
+};
+
+ResultadoLojas simularLojas(Roteamento roteamento, bool roubo) {
+    ResultadoLojas r = {roteamento, roubo, 0, vector<Loja>(numLojas)};
+    vector<Loja>& lojas = r.lojas;
+    for (Loja& l : lojas) l.livres = numBarbeiros;
+
+    priority_queue<EventoLoja, vector<EventoLoja>, EventoPosterior> eventos;
+    long long fim = duracaoSimulacao * 1000000LL;
+    size_t proximaTrace = 0;
+    long long ordem = 0;
+    semearThread(0);
+    seed_seq sementeRoteador{sementeBase, 0u, 1u};
+    mt19937_64 roteador(sementeRoteador);
+
+    // O intervalo --chegada vale por loja: o sistema recebe numLojas vezes mais
+    auto proximaChegada = [&](long long agora) -> long long {
+        if (chegadasTrace.empty()) return agora + sortearChegadaUs() / numLojas;
+        return proximaTrace < chegadasTrace.size() ? chegadasTrace[proximaTrace++] : -1;
+    };
+
+    // Clientes na loja (em espera + em atendimento)
+    auto carga = [&](int i) { return (int)lojas[i].fila.size() + numBarbeiros - lojas[i].livres; };
+
+    auto escolherLoja = [&]() -> int {
+        if (numLojas == 1) return 0;
+        uniform_int_distribution<int> sorteio(0, numLojas - 1);
+        if (roteamento == ALEATORIO) return sorteio(roteador);
+        if (roteamento == DUAS_ESCOLHAS) {
+            int a = sorteio(roteador);
+            int b = uniform_int_distribution<int>(0, numLojas - 2)(roteador);
+            if (b >= a) b++;
+            return carga(b) < carga(a) ? b : a;
+        }
+        // Menor fila: a varredura começa numa loja sorteada para desempatar sem viés
+        int inicio = sorteio(roteador), melhor = inicio;
+        for (int k = 1; k < numLojas; k++) {
+            int i = (inicio + k) % numLojas;
+            if (carga(i) < carga(melhor)) melhor = i;
+        }
+        return melhor;
+    };
+
+    auto atender = [&](int loja, ClienteLoja c, long long agora) {
+        Loja& l = lojas[loja];
+        l.livres--;
+        if (loja != c.loja) l.roubados++;
+        c.cliente.estado = ATENDIDO;
+        c.cliente.inicioAtendimento = agora;
+        eventos.push({agora + c.duracao, ordem++, FIM_ATENDIMENTO, loja, c});
+    };
+
+    long long primeira = proximaChegada(0);
+    if (primeira >= 0) eventos.push({primeira, ordem++, CHEGADA, -1, ClienteLoja()});
+    while (!eventos.empty() && eventos.top().tempo <= fim) {
+        EventoLoja e = eventos.top();
+        eventos.pop();
+        r.eventos++;
+
+        if (e.tipo == CHEGADA) {
+            ClienteLoja c;
+            c.cliente = {proximoClienteId++, ENTRA, e.tempo, 0, 0};
+            c.duracao = sortearAtendimentoUs();
+            c.loja = escolherLoja();
+            Loja& l = lojas[c.loja];
+            l.chegaram++;
+
+            // Mesma regra de admissão da loja única: o cliente só entra se houver
+            // cadeira na sala de espera, mesmo que um barbeiro esteja livre (com
+            // --cadeiras 0 todos desistem). Com roubo, um barbeiro parado de outra
+            // loja atende na hora (a busca começa numa loja sorteada para não
+            // sobrecarregar a primeira)
+            bool cabe = (int)l.fila.size() < numCadeiras;
+            int outra = -1;
+            if (cabe && roubo && l.livres == 0) {
+                int inicio = uniform_int_distribution<int>(0, numLojas - 1)(roteador);
+                for (int k = 0; k < numLojas && outra < 0; k++) {
+                    int i = (inicio + k) % numLojas;
+                    if (lojas[i].livres > 0) outra = i;
+                }
+            }
+            if (!cabe) {
+                l.desistentes++;
+            } else if (l.livres > 0) {
+                atender(c.loja, c, e.tempo);
+            } else if (outra >= 0) {
+                atender(outra, c, e.tempo);
+            } else {
+                l.acumularFila(e.tempo);
+                c.cliente.estado = AGUARDA;
+                l.fila.push_back(c);
+                l.filaMaxima = max(l.filaMaxima, (int)l.fila.size());
+            }
+            long long seguinte = proximaChegada(e.tempo);
+            if (seguinte >= 0) eventos.push({seguinte, ordem++, CHEGADA, -1, ClienteLoja()});
+        } else {
+            Cliente& c = e.cliente.cliente;
+            c.saida = e.tempo;
+            Loja& origem = lojas[e.cliente.loja];
+            origem.espera.registrar(c.inicioAtendimento - c.chegada);
+            origem.noSistema.registrar(c.saida - c.chegada);
+            Loja& l = lojas[e.loja];
+            l.atendidos++;
+            l.ocupado += c.saida - c.inicioAtendimento;
+            l.livres++;
+
+            // Próximo cliente: da própria fila ou, com roubo, da fila mais longa
+            int de = l.fila.empty() ? -1 : e.loja;
+            for (int i = 0; roubo && de != e.loja && i < numLojas; i++) {
+                if (!lojas[i].fila.empty() && (de < 0 || lojas[i].fila.size() > lojas[de].fila.size())) de = i;
+            }
+            if (de >= 0) {
+                lojas[de].acumularFila(e.tempo);
+                ClienteLoja proximo = lojas[de].fila.front();
+                lojas[de].fila.pop_front();
+                atender(e.loja, proximo, e.tempo);
+            }
+        }
+    }
+    for (Loja& l : lojas) l.acumularFila(fim);
+    return r;
+}
+
+// Totais de todas as lojas de um resultado
+struct TotaisLojas {
+    long long chegaram = 0, desistentes = 0, atendidos = 0, roubados = 0, ocupado = 0, areaFila = 0;
+    Histograma espera, noSistema;
+};
+
+static TotaisLojas somarLojas(const ResultadoLojas& r) {
+    TotaisLojas t;
+    for (const Loja& l : r.lojas) {
+        t.chegaram += l.chegaram;
+        t.desistentes += l.desistentes;
+        t.atendidos += l.atendidos;
+        t.roubados += l.roubados;
+        t.ocupado += l.ocupado;
+        t.areaFila += l.areaFila;
+        t.espera.juntar(l.espera);
+        t.noSistema.juntar(l.noSistema);
+    }
+    return t;
+}
+
+static double utilizacaoLoja(const Loja& l) {
+    return duracaoSimulacao > 0 ? l.ocupado * 100.0 / (duracaoSimulacao * 1e6 * numBarbeiros) : 0;
+}
+
+// Uma linha por política (desistência, espera e desequilíbrio entre lojas) e,
+// com uma política só, o detalhe de cada loja
+void imprimirLojas(const vector<ResultadoLojas>& resultados) {
+    cout << "Lojas: " << numLojas << " x " << numBarbeiros << " barbeiro(s), " << numCadeiras
+         << " cadeira(s) | Tempo virtual: " << duracaoSimulacao << " s\n" << endl;
+    cout << left << setw(11) << "Roteamento" << setw(7) << "Roubo" << right
+         << setw(10) << "Chegaram" << setw(10) << "Desist%"
+         << setw(12) << "Esp p50 ms" << setw(12) << "Esp p99 ms" << setw(12) << "Sis p99 ms"
+         << setw(10) << "Roubos" << setw(16) << "Util min-max%" << endl;
+    cout << fixed;
+    for (const ResultadoLojas& r : resultados) {
+        TotaisLojas t = somarLojas(r);
+        double utilMin = 100, utilMax = 0;
+        for (const Loja& l : r.lojas) {
+            utilMin = min(utilMin, utilizacaoLoja(l));
+            utilMax = max(utilMax, utilizacaoLoja(l));
+        }
+        cout << left << setw(11) << NOMES_ROTEAMENTO[r.roteamento] << setw(7) << (r.roubo ? "sim" : "nao") << right
+             << setw(10) << t.chegaram << setprecision(2)
+             << setw(10) << (t.chegaram > 0 ? t.desistentes * 100.0 / t.chegaram : 0) << setprecision(3)
+             << setw(12) << t.espera.percentil(50) / 1000.0 << setw(12) << t.espera.percentil(99) / 1000.0
+             << setw(12) << t.noSistema.percentil(99) / 1000.0 << setw(10) << t.roubados << setprecision(1)
+             << setw(8) << utilMin << "-" << left << setw(7) << utilMax << right << endl;
+    }
+    if (resultados.size() == 1) {
+        cout << endl;
+        const vector<Loja>& lojas = resultados[0].lojas;
+        for (int i = 0; i < numLojas; i++) {
+            const Loja& l = lojas[i];
+            cout << "Loja " << i + 1 << ": chegaram " << l.chegaram << " | desistiram " << l.desistentes
+                 << " | atendeu " << l.atendidos << " (roubados " << l.roubados << ")" << setprecision(1)
+                 << " | Utilizacao: " << utilizacaoLoja(l) << "%" << setprecision(2)
+                 << " | Fila media: " << (duracaoSimulacao > 0 ? l.areaFila / (duracaoSimulacao * 1e6) : 0)
+                 << " | Fila maxima: " << l.filaMaxima << "/" << numCadeiras << endl;
+        }
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+}
+
+// Linha de CABECALHO_CSV para várias lojas (todas somadas)
+void imprimirCsvLojas(const ResultadoLojas& r) {
+    TotaisLojas t = somarLojas(r);
+    double duracaoUs = duracaoSimulacao * 1e6;
+    cout << fixed << setprecision(3)
+         << t.chegaram << "," << t.atendidos << "," << t.desistentes << ","
+         << (t.chegaram > 0 ? t.atendidos * 100.0 / t.chegaram : 0) << ","
+         << (duracaoSimulacao > 0 ? t.atendidos / (double)duracaoSimulacao : 0) << ","
+         << t.espera.percentil(50) / 1000.0 << "," << t.espera.percentil(90) / 1000.0 << ","
+         << t.espera.percentil(99) / 1000.0 << "," << t.espera.maior() / 1000.0 << ","
+         << (duracaoUs > 0 ? t.areaFila / duracaoUs : 0) << ","
+         << (duracaoUs > 0 ? t.ocupado * 100.0 / (duracaoUs * numBarbeiros * numLojas) : 0) << endl;
+}
+
+// Colunas de resultado da linha CSV (--csv e varredura)
+const char* CABECALHO_CSV = "chegaram,atendidos,desistentes,taxa_atendimento,vazao,"
+                            "espera_p50_ms,espera_p90_ms,espera_p99_ms,espera_max_ms,fila_media,utilizacao_media";
+
+void imprimirUso(const char* programa) {
+    cout << "Uso: " << programa << "   (sem argumentos: parametros pedidos no terminal)\n"
+         << "     " << programa << " [--config arquivo] [--cadeiras N] [--barbeiros N] [--chegada MIN-MAX]\n"
+         << "         [--atendimento MIN-MAX] [--duracao S] [--modo real|virtual] [--seed N] [--csv]\n"
+         << "         [--dist-chegada D] [--dist-atendimento D] [--chegadas arquivo_ms.txt]\n"
+         << "         [--intervalo MS] [--serie serie.csv]   (amostragem do monitor e serie temporal)\n"
+         << "         [--lojas N] [--roteamento aleatorio|jsq|dois|todas] [--roubo]\n"
+         << "  Com --lojas > 1: cada loja tem --barbeiros e --cadeiras, --chegada vale por loja e a\n"
+         << "  simulacao e sempre em tempo virtual; 'todas' compara as politicas com e sem roubo.\n"
+         << "  D = uniforme | exponencial | deterministica (as duas ultimas usam a media de MIN-MAX)\n"
+         << "     " << programa << " --varrer arquivo [--trabalhadores N] [--seed N] [--saida resultados.csv]\n"
+         << "  No arquivo de varredura cada linha e chave=v1,v2,...; roda todas as combinacoes." << endl;
+}
+
+int main(int argc, char** argv) {
+    Opcoes opcoes;
+    if (!lerArgumentos(argc, argv, opcoes)) {
+        imprimirUso(argv[0]);
+        return 1;
+    }
+    if (opcoes.count("ajuda")) {
+        imprimirUso(argv[0]);
+        return 0;
+    }
+    int varredura = talvezVarrer(argv[0], opcoes, CABECALHO_CSV);
+    if (varredura >= 0) return varredura;
     
-    // Entrada de parâmetros
-    cout << "Digite o numero de cadeiras de espera: ";
-    cin >> numCadeiras;
-    cout << "Digite taxa de chegada de clientes (min ms max ms): ";
-    cin >> taxaChegadaMin >> taxaChegadaMax;
-    cout << "Digite tempo de atendimento (min ms max ms): ";
-    cin >> tempoAtendimentoMin >> tempoAtendimentoMax;
-    cout << "Digite a duracao da simulacao (s): ";
-    cin >> duracaoSimulacao;
+    bool modoCsv = opcoes.count("csv") > 0;
+    int modo = 1;
+    if (argc > 1) {
+        // Parâmetros pela linha de comando/arquivo (valores ausentes usam o padrão)
+        numCadeiras = opcaoInt(opcoes, "cadeiras", 5);
+        numBarbeiros = opcaoInt(opcoes, "barbeiros", 1);
+        taxaChegadaMin = 100, taxaChegadaMax = 200;
+        opcaoIntervalo(opcoes, "chegada", taxaChegadaMin, taxaChegadaMax);
+        tempoAtendimentoMin = 150, tempoAtendimentoMax = 300;
+        opcaoIntervalo(opcoes, "atendimento", tempoAtendimentoMin, tempoAtendimentoMax);
+        duracaoSimulacao = opcaoInt(opcoes, "duracao", 10);
+        string nomeModo = opcoes.count("modo") ? opcoes["modo"] : "real";
+        modo = (nomeModo == "virtual" || nomeModo == "2") ? 2 : 1;
+        if (opcoes.count("dist-chegada")) distChegada = lerDistribuicao(opcoes["dist-chegada"]);
+        if (opcoes.count("dist-atendimento")) distAtendimento = lerDistribuicao(opcoes["dist-atendimento"]);
+        if (opcoes.count("chegadas") && !lerChegadas(opcoes["chegadas"])) return 1;
+        intervaloMonitorMs = max(1, opcaoInt(opcoes, "intervalo", 1000));
+        numLojas = max(1, opcaoInt(opcoes, "lojas", 1));
+        if (opcoes.count("serie")) {
+            serieCsv.open(opcoes["serie"]);
+            if (!serieCsv.is_open()) {
+                cerr << "Erro: Nao foi possivel criar " << opcoes["serie"] << endl;
+                return 1;
+            }
+        }
+        sementeBase = opcoes.count("seed") ? (unsigned)opcaoInt(opcoes, "seed", 1) : (unsigned)time(nullptr);
+    } else {
+        // Semente da execução (cada thread deriva a sua)
+        sementeBase = (unsigned)time(nullptr);
+        
+        // Entrada de parâmetros
+        cout << "Digite o numero de cadeiras de espera: ";
+        cin >> numCadeiras;
+        cout << "Digite o numero de barbeiros: ";
+        cin >> numBarbeiros;
+        cout << "Digite taxa de chegada de clientes (min ms max ms): ";
+        cin >> taxaChegadaMin >> taxaChegadaMax;
+        cout << "Digite tempo de atendimento (min ms max ms): ";
+        cin >> tempoAtendimentoMin >> tempoAtendimentoMax;
+        cout << "Digite a duracao da simulacao (s): ";
+        cin >> duracaoSimulacao;
+        cout << "Digite o modo (1 = threads em tempo real, 2 = eventos em tempo virtual): ";
+        cin >> modo;
+    }
+    if (taxaChegadaMax < taxaChegadaMin) swap(taxaChegadaMin, taxaChegadaMax);
+    if (tempoAtendimentoMax < tempoAtendimentoMin) swap(tempoAtendimentoMin, tempoAtendimentoMax);
+    
+    if (numCadeiras < 0) numCadeiras = 0;
+    if (numBarbeiros < 1) numBarbeiros = 1;
+    filaEspera.reset(new FilaMPMC<Cliente>(numCadeiras));
+    barbeiros.reset(new Barbeiro[numBarbeiros]);
+    for (int i = 0; i < numBarbeiros; i++) {
+        barbeiros[i].estado = DORME;
+        barbeiros[i].atendidos = 0;
+        barbeiros[i].esperaPorSegundo.assign(max(duracaoSimulacao, 0) + 1, 0);
+    }
+    esperaNaoAtendidos.assign(max(duracaoSimulacao, 0) + 1, 0);
+    
+    if (!modoCsv) cout << "\n=== Simulacao da Barbearia ===\n" << endl;
+    
+    if (numLojas > 1) {
+        if (chegadasTrace.empty() && taxaChegadaMax <= 0) {
+            cerr << "Erro: com varias lojas o intervalo maximo entre chegadas deve ser maior que zero." << endl;
+            return 1;
+        }
+        if (modo == 1 && opcoes.count("modo")) cerr << "Aviso: varias lojas rodam em tempo virtual." << endl;
+        string nome = opcoes.count("roteamento") ? opcoes["roteamento"] : "aleatorio";
+        bool roubo = opcaoInt(opcoes, "roubo", 0) != 0;
+        vector<ResultadoLojas> resultados;
+        if (nome == "todas" && !modoCsv) {
+            for (int rt = ALEATORIO; rt <= DUAS_ESCOLHAS; rt++) {
+                resultados.push_back(simularLojas((Roteamento)rt, false));
+                resultados.push_back(simularLojas((Roteamento)rt, true));
+            }
+        } else {
+            int rt = ALEATORIO;
+            while (rt <= DUAS_ESCOLHAS && nome != NOMES_ROTEAMENTO[rt]) rt++;
+            if (rt > DUAS_ESCOLHAS) {
+                cerr << "Erro: roteamento invalido: " << nome
+                     << (modoCsv ? " (use aleatorio, jsq ou dois)" : " (use aleatorio, jsq, dois ou todas)") << endl;
+                return 1;
+            }
+            resultados.push_back(simularLojas((Roteamento)rt, roubo));
+        }
+        if (modoCsv) imprimirCsvLojas(resultados[0]);
+        else imprimirLojas(resultados);
+        return 0;
+    }
     
-    cout << "\n=== Simulacao da Barbearia ===\n" << endl;
+    if (modo == 2) {
+        // Intervalo zero entre chegadas nunca deixaria o relógio virtual avançar
+        if (chegadasTrace.empty() && taxaChegadaMax <= 0) {
+            cerr << "Erro: no modo virtual o intervalo maximo entre chegadas deve ser maior que zero." << endl;
+            return 1;
+        }
+        auto inicio = chrono::steady_clock::now();
+        long long eventos = simularTempoVirtual();
+        double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (modoCsv) {
+            imprimirCsv();
+            return 0;
+        }
+        cout << "Tempo virtual: " << duracaoSimulacao << " s | Eventos: " << eventos
+             << " | Tempo real: " << segundos * 1000.0 << " ms" << endl;
+        imprimirResumo();
+        return 0;
+    }
     
     // Cria threads
-    thread tBarbeiro(barbeiro);
+    inicioSimulacao = chrono::steady_clock::now();
+    vector<thread> tBarbeiros;
+    for (int i = 0; i < numBarbeiros; i++) {
+        tBarbeiros.emplace_back(barbeiro, i);
+    }
     thread tGerador(gerarClientes);
-    thread tMonitor(monitor);
+    thread tMonitor;
+    if (!modoCsv || serieCsv.is_open()) tMonitor = thread(monitor, !modoCsv);
     
     // Roda por tempo determinado
     this_thread::sleep_for(chrono::seconds(duracaoSimulacao));
     rodando = false;
     
     // Acorda todas as threads para finalizar
-    cvBarbeiro.notify_all();
+    {
+        lock_guard<mutex> lock(mutexSono);
+        cvBarbeiro.notify_all();
+    }
     cvCliente.notify_all();
     
     // Aguarda encerramento
-    tBarbeiro.join();
+    for (auto &t : tBarbeiros) t.join();
     tGerador.join();
-    tMonitor.join();
+    if (tMonitor.joinable()) tMonitor.join();
+    
+    // Quem sobrou na fila esperou até o fim
+    Cliente restante;
+    while (filaEspera->tentaRemover(restante)) registrarNaoAtendido(restante);
     
-    // Estatísticas finais
+    if (modoCsv) imprimirCsv();
+    else imprimirResumo();
+    return 0;
+}
+
+// Estatísticas finais (comuns aos dois modos)
+void imprimirResumo() {
+    int clientesAtendidos = totalAtendidos();
     cout << "\n=== Resumo Final ===" << endl;
     cout << "Total de clientes que chegaram: " << totalClientesChegaram << endl;
     cout << "Clientes atendidos: " << clientesAtendidos << endl;
@@ -183,6 +1113,94 @@ int main() {
         (totalClientesChegaram > 0 ? 
          (clientesAtendidos * 100.0 / totalClientesChegaram) : 0) 
         << "%" << endl;
-    
-    return 0;
+    cout << "Vazao: " << (duracaoSimulacao > 0 ? clientesAtendidos / (double)duracaoSimulacao : 0)
+         << " clientes/s" << endl;
+    for (int i = 0; i < numBarbeiros; i++) {
+        cout << "Barbeiro " << i + 1 << " atendeu: " << barbeiros[i].atendidos;
+        cout << " | Utilizacao: " << fixed << setprecision(1)
+             << (duracaoSimulacao > 0 ? barbeiros[i].tempoOcupado / (duracaoSimulacao * 1e4) : 0) << "%" << endl;
+        cout.unsetf(ios::floatfield);
+        cout << setprecision(6);
+    }
+    imprimirLatencias();
+}
+
+static void imprimirLinhaLatencia(const char* rotulo, const Histograma& h) {
+    cout << left << setw(14) << rotulo << right << fixed << setprecision(3)
+         << " p50: " << setw(9) << h.percentil(50) / 1000.0
+         << " | p90: " << setw(9) << h.percentil(90) / 1000.0
+         << " | p99: " << setw(9) << h.percentil(99) / 1000.0
+         << " | max: " << setw(9) << h.maior() / 1000.0
+         << " | media: " << setw(9) << h.media() / 1000.0 << endl;
+}
+
+// Soma os histogramas e a série de espera de todos os barbeiros (e dos não atendidos)
+static void juntarEstatisticas(Histograma& espera, Histograma& atendimento, Histograma& noSistema,
+                               vector<long long>& esperaPorSegundo) {
+    esperaPorSegundo = esperaNaoAtendidos;
+    for (int i = 0; i < numBarbeiros; i++) {
+        espera.juntar(barbeiros[i].espera);
+        atendimento.juntar(barbeiros[i].atendimento);
+        noSistema.juntar(barbeiros[i].noSistema);
+        for (size_t s = 0; s < esperaPorSegundo.size(); s++) {
+            esperaPorSegundo[s] += barbeiros[i].esperaPorSegundo[s];
+        }
+    }
+}
+
+// Uma linha com as colunas de CABECALHO_CSV
+void imprimirCsv() {
+    Histograma espera, atendimento, noSistema;
+    vector<long long> esperaPorSegundo;
+    juntarEstatisticas(espera, atendimento, noSistema, esperaPorSegundo);
+
+    int atendidos = totalAtendidos();
+    long long somaEspera = 0, ocupado = 0;
+    for (long long v : esperaPorSegundo) somaEspera += v;
+    for (int i = 0; i < numBarbeiros; i++) ocupado += barbeiros[i].tempoOcupado;
+    double duracaoUs = duracaoSimulacao * 1e6;
+
+    cout << fixed << setprecision(3)
+         << totalClientesChegaram << "," << atendidos << "," << clientesDesistentes << ","
+         << (totalClientesChegaram > 0 ? atendidos * 100.0 / totalClientesChegaram : 0) << ","
+         << (duracaoSimulacao > 0 ? atendidos / (double)duracaoSimulacao : 0) << ","
+         << espera.percentil(50) / 1000.0 << "," << espera.percentil(90) / 1000.0 << ","
+         << espera.percentil(99) / 1000.0 << "," << espera.maior() / 1000.0 << ","
+         << (duracaoUs > 0 ? somaEspera / duracaoUs : 0) << ","
+         << (duracaoUs > 0 ? ocupado * 100.0 / (duracaoUs * numBarbeiros) : 0) << endl;
+}
+
+// Latências por cliente atendido (histogramas de todos os barbeiros somados)
+// e tamanho médio da fila ao longo do tempo
+void imprimirLatencias() {
+    Histograma espera, atendimento, noSistema;
+    vector<long long> esperaPorSegundo;
+    juntarEstatisticas(espera, atendimento, noSistema, esperaPorSegundo);
+
+    cout << "\n=== Latencias dos atendidos (ms) ===" << endl;
+    imprimirLinhaLatencia("Espera:", espera);
+    imprimirLinhaLatencia("Atendimento:", atendimento);
+    imprimirLinhaLatencia("No sistema:", noSistema);
+
+    // Média no tempo (lei de Little: soma das esperas / duração) e série por
+    // intervalo; com muitos segundos, agrupa em até 20 intervalos
+    long long somaEspera = 0;
+    for (long long v : esperaPorSegundo) somaEspera += v;
+    cout << "\nFila media: " << fixed << setprecision(2)
+         << (duracaoSimulacao > 0 ? somaEspera / (duracaoSimulacao * 1e6) : 0)
+         << " | Fila maxima: " << filaMaxima << "/" << numCadeiras << endl;
+    if (duracaoSimulacao > 0) {
+        int passo = (duracaoSimulacao + 19) / 20;
+        cout << "Fila media ao longo do tempo:" << endl;
+        for (int inicio = 0; inicio < duracaoSimulacao; inicio += passo) {
+            int fim = min(inicio + passo, duracaoSimulacao);
+            long long soma = 0;
+            for (int s = inicio; s < fim; s++) soma += esperaPorSegundo[s];
+            cout << "  " << setw(6) << inicio << "-" << left << setw(6) << to_string(fim) + "s" << right
+                 << setw(8) << soma / ((fim - inicio) * 1e6) << " ";
+            cout << string((size_t)min(50.0, soma / ((fim - inicio) * 1e6) * 50.0 / max(numCadeiras, 1)), '#') << endl;
+        }
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
 }
@@ -0,0 +1,291 @@
+#ifndef CORROTINAS_H
+#define CORROTINAS_H
+
+// Escalonador de corrotinas C++20 (requer -std=c++20): um pool de threads
+// com roubo de trabalho, uma roda de temporização para esperas e um mutex
+// assíncrono cuja espera suspende a corrotina em vez de bloquear a thread.
+// Permite simular centenas de milhares de agentes com poucas threads.
+
+#include <coroutine>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+
+// Corrotina disparada e esquecida: começa suspensa (quem cria a entrega ao
+// pool) e o quadro é destruído sozinho ao terminar
+struct Tarefa {
+    struct promise_type {
+        Tarefa get_return_object() {
+            return Tarefa{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Índice do trabalhador na thread atual (-1 fora do pool)
+inline thread_local int trabalhadorAtual = -1;
+
+// Lido por uma função que não é expandida dentro da corrotina: o compilador
+// poderia guardar o endereço da variável de thread de antes de uma suspensão
+// e usá-lo depois de a corrotina ser retomada em outra thread
+[[gnu::noinline]] inline int indiceTrabalhador() {
+    return trabalhadorAtual;
+}
+
+// Pool com uma fila por trabalhador: o dono tira do começo da própria fila
+// (FIFO, para que nenhuma corrotina pronta fique para trás quando o pool está
+// sobrecarregado) e quem está sem trabalho rouba do fim da fila dos outros
+class PoolRoubo {
+public:
+    PoolRoubo(int trabalhadores, std::function<void(int)> aoIniciar)
+        : numFilas(trabalhadores < 1 ? 1 : trabalhadores), filas(new Fila[numFilas]),
+          parando(false), pendentes(0), ociosos(0), proximaExterna(0) {
+        for (int i = 0; i < numFilas; i++) {
+            threads.emplace_back([this, i, aoIniciar] {
+                trabalhadorAtual = i;
+                if (aoIniciar) aoIniciar(i);
+                trabalhador(i);
+            });
+        }
+    }
+
+    ~PoolRoubo() { parar(); }
+
+    // Coloca a corrotina para rodar: na fila da thread atual, se for do pool,
+    // ou distribuída em rodízio se vier de fora (main, roda de temporização)
+    void agendar(std::coroutine_handle<> h) {
+        int i = indiceTrabalhador();
+        if (i < 0) i = (int)(proximaExterna++ % numFilas);
+        {
+            std::lock_guard<std::mutex> lock(filas[i].m);
+            filas[i].tarefas.push_back(h);
+        }
+        pendentes++;
+        // Pareia com o trabalhador que vai dormir: ou ele vê a tarefa
+        // pendente, ou aqui se vê o ocioso
+        if (ociosos.load() > 0) {
+            std::lock_guard<std::mutex> lock(mSono);
+            cvSono.notify_one();
+        }
+    }
+
+    void parar() {
+        if (parando.exchange(true)) return;
+        {
+            std::lock_guard<std::mutex> lock(mSono);
+            cvSono.notify_all();
+        }
+        for (auto& t : threads) t.join();
+    }
+
+    int tamanho() const { return numFilas; }
+
+private:
+    struct Fila {
+        std::mutex m;
+        std::deque<std::coroutine_handle<>> tarefas;
+        char preenchimento[64];  // filas vizinhas em linhas de cache diferentes
+    };
+
+    bool pegar(int i, std::coroutine_handle<>& h) {
+        {
+            std::lock_guard<std::mutex> lock(filas[i].m);
+            if (!filas[i].tarefas.empty()) {
+                h = filas[i].tarefas.front();
+                filas[i].tarefas.pop_front();
+                return true;
+            }
+        }
+        for (int k = 1; k < numFilas; k++) {
+            Fila& vitima = filas[(i + k) % numFilas];
+            std::lock_guard<std::mutex> lock(vitima.m);
+            if (!vitima.tarefas.empty()) {
+                h = vitima.tarefas.back();
+                vitima.tarefas.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void trabalhador(int i) {
+        std::coroutine_handle<> h;
+        while (!parando) {
+            if (pegar(i, h)) {
+                pendentes--;
+                h.resume();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mSono);
+            ociosos++;
+            cvSono.wait(lock, [&] { return pendentes.load() > 0 || parando; });
+            ociosos--;
+        }
+    }
+
+    int numFilas;
+    std::unique_ptr<Fila[]> filas;
+    std::vector<std::thread> threads;
+    std::atomic<bool> parando;
+    std::atomic<long> pendentes;
+    std::atomic<int> ociosos;
+    std::atomic<unsigned> proximaExterna;
+    std::mutex mSono;
+    std::condition_variable cvSono;
+};
+
+// Roda de temporização com resolução de 1 ms: cada espera vai para a posição
+// (instante alvo % POSICOES); uma thread avança um tique por milissegundo e
+// devolve ao pool as corrotinas vencidas. Esperas maiores que a roda ficam
+// na posição por mais de uma volta.
+class RodaTempo {
+public:
+    static const int POSICOES = 4096;
+
+    explicit RodaTempo(PoolRoubo& pool)
+        : pool(pool), posicoes(new Posicao[POSICOES]), tique(0), parando(false),
+          inicio(std::chrono::steady_clock::now()) {
+        thread = std::thread([this] { avancar(); });
+    }
+
+    ~RodaTempo() { parar(); }
+
+    void agendar(std::coroutine_handle<> h, long long ms) {
+        if (ms <= 0) {
+            pool.agendar(h);
+            return;
+        }
+        uint64_t alvo = tique.load() + ms;
+        Posicao& p = posicoes[alvo % POSICOES];
+        {
+            std::lock_guard<std::mutex> lock(p.m);
+            // O tique é publicado antes de a posição ser varrida: se ele já
+            // chegou ao alvo, a varredura pode ter passado e a corrotina segue
+            if (alvo > tique.load()) {
+                p.entradas.push_back({alvo, h});
+                return;
+            }
+        }
+        pool.agendar(h);
+    }
+
+    void parar() {
+        if (parando.exchange(true)) return;
+        thread.join();
+    }
+
+private:
+    struct Entrada {
+        uint64_t alvo;
+        std::coroutine_handle<> h;
+    };
+
+    struct Posicao {
+        std::mutex m;
+        std::vector<Entrada> entradas;
+    };
+
+    void avancar() {
+        std::vector<std::coroutine_handle<>> vencidas;
+        for (uint64_t t = 1; !parando; t++) {
+            // Atrasada (thread sem CPU), a roda recupera os tiques sem dormir
+            std::this_thread::sleep_until(inicio + std::chrono::milliseconds(t));
+            tique.store(t);
+            Posicao& p = posicoes[t % POSICOES];
+            {
+                std::lock_guard<std::mutex> lock(p.m);
+                size_t restantes = 0;
+                for (size_t i = 0; i < p.entradas.size(); i++) {
+                    if (p.entradas[i].alvo <= t) vencidas.push_back(p.entradas[i].h);
+                    else p.entradas[restantes++] = p.entradas[i];
+                }
+                p.entradas.resize(restantes);
+            }
+            for (auto h : vencidas) pool.agendar(h);
+            vencidas.clear();
+        }
+    }
+
+    PoolRoubo& pool;
+    std::unique_ptr<Posicao[]> posicoes;
+    std::atomic<uint64_t> tique;
+    std::atomic<bool> parando;
+    std::chrono::steady_clock::time_point inicio;
+    std::thread thread;
+};
+
+// co_await esperar(roda, ms): suspende a corrotina por ms milissegundos
+struct Espera {
+    RodaTempo& roda;
+    long long ms;
+    bool await_ready() const noexcept { return ms <= 0; }
+    void await_suspend(std::coroutine_handle<> h) { roda.agendar(h, ms); }
+    void await_resume() const noexcept {}
+};
+
+inline Espera esperar(RodaTempo& roda, long long ms) {
+    return Espera{roda, ms};
+}
+
+// Mutex de corrotinas: travar() suspende quem não conseguiu e liberar()
+// passa a posse direto para o primeiro da fila. O std::mutex interno só
+// protege o estado e nunca fica travado durante uma suspensão.
+class MutexAssincrono {
+public:
+    struct Travar {
+        MutexAssincrono& mutex;
+        bool await_ready() { return mutex.tentarTravar(); }
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::lock_guard<std::mutex> lock(mutex.m);
+            if (!mutex.travado) {
+                mutex.travado = true;
+                return false;  // liberado entre await_ready e agora: segue sem suspender
+            }
+            mutex.esperando.push_back(h);
+            return true;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    Travar travar() { return Travar{*this}; }
+
+    bool tentarTravar() {
+        std::lock_guard<std::mutex> lock(m);
+        if (travado) return false;
+        travado = true;
+        return true;
+    }
+
+    void liberar(PoolRoubo& pool) {
+        std::coroutine_handle<> proximo;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (esperando.empty()) {
+                travado = false;
+                return;
+            }
+            proximo = esperando.front();
+            esperando.erase(esperando.begin());
+        }
+        pool.agendar(proximo);
+    }
+
+private:
+    std::mutex m;
+    bool travado = false;
+    std::vector<std::coroutine_handle<>> esperando;  // poucos por garfo: vetor basta
+};
+
+#endif // CORROTINAS_H
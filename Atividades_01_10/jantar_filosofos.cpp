@@ -1,11 +1,20 @@
 #include <iostream>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <vector>
+#include <string>
 #include <cstdlib>
 #include <ctime>
 #include <chrono>
 #include <atomic>
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include "varredura.h"
+#if defined(__cpp_impl_coroutine)
+#include "corrotinas.h"
+#endif
 
 using namespace std;
 
@@ -15,20 +24,95 @@ struct Filosofo {
     int id;
     Estado estado;
     int refeicoes;
+    // Escritos só pela thread do próprio filósofo; lidos depois do join
+    long long fomeMaxima;   // maior espera COM_FOME -> COMENDO (us)
+    long long fomeTotal;    // soma das esperas (us)
 };
 
+// Estratégias para pegar os garfos sem deadlock
+enum Estrategia { ORDEM, GARCOM, TENTATIVA, CHANDY_MISRA };
+const char* NOMES_ESTRATEGIA[] = {"ordem", "garcom", "tentativa", "chandy-misra"};
+const int NUM_ESTRATEGIAS = 4;
+
 int N; // número de filósofos
 int duracaoSimulacao; // em segundos
 int tempoPensarMin, tempoPensarMax;
 int tempoComerMin, tempoComerMax;
+unsigned semente = 1;
+Estrategia estrategia = ORDEM;
+double duracaoMedida = 0; // segundos de fato decorridos (com muitas threads o sleep atrasa)
+bool modoCorrotinas = false;
+const int LIMITE_DETALHE = 20; // acima disso monitor e resumo mostram só totais
 
 vector<mutex> garfos;     // um mutex para cada garfo
 vector<Filosofo> filosofos;
 atomic<bool> rodando(true);
 
+// Semáforo contador (C++14 não tem std::counting_semaphore)
+class Semaforo {
+public:
+    explicit Semaforo(int inicial = 0) : contador(inicial) {}
+
+    void adquirir() {
+        unique_lock<mutex> lock(m);
+        cv.wait(lock, [&] { return contador > 0; });
+        contador--;
+    }
+
+    void liberar() {
+        {
+            lock_guard<mutex> lock(m);
+            contador++;
+        }
+        cv.notify_one();
+    }
+
+    void reiniciar(int valor) {
+        lock_guard<mutex> lock(m);
+        contador = valor;
+    }
+
+private:
+    mutex m;
+    condition_variable cv;
+    int contador;
+};
+
+// Garçom: no máximo N-1 filósofos disputam garfos ao mesmo tempo
+Semaforo garcom;
+
+// Chandy–Misra: cada filósofo tem uma caixa de mensagens protegida pelo
+// próprio mutex; pedir e entregar um garfo é escrever na caixa do vizinho
+// (nunca se seguram dois mutexes ao mesmo tempo)
+enum { ESQ, DIR };  // garfo id e garfo (id + 1) % N do filósofo id
+
+struct CaixaCM {
+    mutex m;
+    condition_variable cv;
+    bool tenho[2];
+    bool sujo[2];
+    bool pedido[2];          // vizinho pediu o garfo que está comigo
+    bool pedidoEnviado[2];   // já pedi o garfo que está com o vizinho
+    bool comendo;
+};
+
+vector<CaixaCM> caixas;
+
+// Gerador próprio de cada thread (rand() não é seguro entre threads)
+thread_local mt19937 gerador;
+
+void semearThread(unsigned indice) {
+    seed_seq sequencia{semente, indice};
+    gerador.seed(sequencia);
+}
+
 // Função auxiliar para gerar tempo aleatório entre min e max (ms)
 int tempoAleatorio(int min, int max) {
-    return min + rand() % (max - min + 1);
+    return uniform_int_distribution<int>(min, max)(gerador);
+}
+
+long long agoraUs() {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 void pensar(int id) {
@@ -42,42 +126,220 @@ void comer(int id) {
     filosofos[id].refeicoes++;
 }
 
-// Lógica do filósofo
-void filosofo(int id) {
-    int esquerda = id;
-    int direita = (id + 1) % N;
+void registrarFome(int id, long long inicio) {
+    long long fome = agoraUs() - inicio;
+    filosofos[id].fomeMaxima = max(filosofos[id].fomeMaxima, fome);
+    filosofos[id].fomeTotal += fome;
+}
 
+// Estratégia ordem: sempre pegar o garfo de menor índice primeiro
+void filosofoOrdem(int id, int esquerda, int direita) {
     while (rodando) {
         pensar(id);
 
         filosofos[id].estado = COM_FOME;
+        long long inicio = agoraUs();
 
-        // Estratégia: sempre pegar o garfo de menor índice primeiro (para evitar deadlock)
         int primeiro = min(esquerda, direita);
         int segundo = max(esquerda, direita);
 
         unique_lock<mutex> lock1(garfos[primeiro]);
         unique_lock<mutex> lock2(garfos[segundo]);
 
+        registrarFome(id, inicio);
         comer(id);
     }
 }
 
+// Estratégia garçom: pede licença antes dos garfos; com N-1 licenças o ciclo
+// de espera circular não fecha e os garfos podem ser pegos na ordem natural
+void filosofoGarcom(int id, int esquerda, int direita) {
+    while (rodando) {
+        pensar(id);
+
+        filosofos[id].estado = COM_FOME;
+        long long inicio = agoraUs();
+
+        garcom.adquirir();
+        {
+            unique_lock<mutex> lock1(garfos[esquerda]);
+            unique_lock<mutex> lock2(garfos[direita]);
+            registrarFome(id, inicio);
+            comer(id);
+        }
+        garcom.liberar();
+    }
+}
+
+// Estratégia tentativa: pega o garfo esquerdo e tenta o direito; se estiver
+// ocupado, devolve o esquerdo e espera um tempo aleatório que dobra a cada
+// falha (até o tempo máximo de comer), para os vizinhos não colidirem de novo
+void filosofoTentativa(int id, int esquerda, int direita) {
+    const int recuoMinimoUs = 100;
+    const int recuoMaximoUs = max(recuoMinimoUs, tempoComerMax * 1000);
+    while (rodando) {
+        pensar(id);
+
+        filosofos[id].estado = COM_FOME;
+        long long inicio = agoraUs();
+
+        int recuo = recuoMinimoUs;
+        for (;;) {
+            unique_lock<mutex> lock1(garfos[esquerda]);
+            unique_lock<mutex> lock2(garfos[direita], try_to_lock);
+            if (lock2.owns_lock()) {
+                registrarFome(id, inicio);
+                comer(id);
+                break;
+            }
+            lock1.unlock();
+            this_thread::sleep_for(chrono::microseconds(tempoAleatorio(0, recuo)));
+            recuo = min(recuo * 2, recuoMaximoUs);
+        }
+    }
+}
+
+// Entrega um garfo ao vizinho (já limpo)
+void enviarGarfo(int para, int lado) {
+    CaixaCM& c = caixas[para];
+    {
+        lock_guard<mutex> lock(c.m);
+        c.tenho[lado] = true;
+        c.sujo[lado] = false;
+        c.pedidoEnviado[lado] = false;
+    }
+    c.cv.notify_one();
+}
+
+void enviarPedido(int para, int lado) {
+    CaixaCM& c = caixas[para];
+    {
+        lock_guard<mutex> lock(c.m);
+        c.pedido[lado] = true;
+    }
+    c.cv.notify_one();
+}
+
+// Estratégia Chandy–Misra: garfo sujo pedido é entregue (a menos que o dono
+// esteja comendo); garfo limpo fica com quem o recebeu até comer. Começa com
+// cada garfo sujo com o filósofo de menor id, o que torna o grafo de
+// precedência acíclico
+void filosofoChandyMisra(int id) {
+    CaixaCM& eu = caixas[id];
+    int vizinho[2] = {(id + N - 1) % N, (id + 1) % N};
+    int ladoNoVizinho[2] = {DIR, ESQ};
+    bool entregar[2], pedir[2];
+
+    // Com o mutex da caixa: separa os garfos sujos pedidos para entregar
+    auto separarEntregas = [&]() {
+        for (int lado = 0; lado < 2; lado++) {
+            entregar[lado] = eu.pedido[lado] && eu.tenho[lado] && eu.sujo[lado] && !eu.comendo;
+            if (entregar[lado]) {
+                eu.tenho[lado] = false;
+                eu.pedido[lado] = false;
+            }
+        }
+        return entregar[ESQ] || entregar[DIR];
+    };
+    // Sem o mutex: envia as mensagens separadas
+    auto enviar = [&]() {
+        for (int lado = 0; lado < 2; lado++) {
+            if (entregar[lado]) enviarGarfo(vizinho[lado], ladoNoVizinho[lado]);
+            if (pedir[lado]) enviarPedido(vizinho[lado], ladoNoVizinho[lado]);
+            entregar[lado] = pedir[lado] = false;
+        }
+    };
+    entregar[ESQ] = entregar[DIR] = pedir[ESQ] = pedir[DIR] = false;
+
+    while (rodando) {
+        // Pensa atendendo pedidos até o prazo
+        filosofos[id].estado = PENSANDO;
+        auto prazo = chrono::steady_clock::now() + chrono::milliseconds(tempoAleatorio(tempoPensarMin, tempoPensarMax));
+        {
+            unique_lock<mutex> lock(eu.m);
+            while (rodando && chrono::steady_clock::now() < prazo) {
+                if (separarEntregas()) {
+                    lock.unlock();
+                    enviar();
+                    lock.lock();
+                    continue;
+                }
+                eu.cv.wait_until(lock, prazo);
+            }
+        }
+
+        filosofos[id].estado = COM_FOME;
+        long long inicio = agoraUs();
+
+        bool pronto = false;
+        while (rodando && !pronto) {
+            unique_lock<mutex> lock(eu.m);
+            bool mensagens = separarEntregas();
+            for (int lado = 0; lado < 2; lado++) {
+                pedir[lado] = !eu.tenho[lado] && !eu.pedidoEnviado[lado];
+                if (pedir[lado]) eu.pedidoEnviado[lado] = mensagens = true;
+            }
+            pronto = eu.tenho[ESQ] && eu.tenho[DIR];
+            if (pronto) eu.comendo = true;
+            else if (!mensagens && rodando) eu.cv.wait(lock);
+            lock.unlock();
+            enviar();
+        }
+        if (!pronto) break;
+
+        registrarFome(id, inicio);
+        comer(id);
+
+        // Depois de comer os dois garfos ficam sujos; pedidos adiados são atendidos
+        {
+            lock_guard<mutex> lock(eu.m);
+            eu.sujo[ESQ] = eu.sujo[DIR] = true;
+            eu.comendo = false;
+            separarEntregas();
+        }
+        enviar();
+    }
+}
+
+// Lógica do filósofo
+void filosofo(int id) {
+    int esquerda = id;
+    int direita = (id + 1) % N;
+    semearThread(id);
+
+    switch (estrategia) {
+        case ORDEM:        filosofoOrdem(id, esquerda, direita); break;
+        case GARCOM:       filosofoGarcom(id, esquerda, direita); break;
+        case TENTATIVA:    filosofoTentativa(id, esquerda, direita); break;
+        case CHANDY_MISRA: filosofoChandyMisra(id); break;
+    }
+}
+
 // Impressão do estado do sistema
 void monitor() {
     using namespace chrono_literals;
     while (rodando) {
         this_thread::sleep_for(1s);
 
-        // Estado dos garfos
+        // Muitos filósofos: só quantos estão em cada estado
+        if (N > LIMITE_DETALHE) {
+            int quantos[3] = {0, 0, 0};
+            long long refeicoes = 0;
+            for (int i = 0; i < N; i++) {
+                quantos[filosofos[i].estado]++;
+                refeicoes += filosofos[i].refeicoes;
+            }
+            cout << "Pensando: " << quantos[PENSANDO] << " | Com fome: " << quantos[COM_FOME]
+                 << " | Comendo: " << quantos[COMENDO] << " | Refeicoes: " << refeicoes << endl;
+            continue;
+        }
+
+        // Estado dos garfos (em uso quando um dos dois vizinhos come; não
+        // usa try_lock para não disputar os garfos com os filósofos)
         cout << "Garfos: ";
         for (int i = 0; i < N; i++) {
-            if (garfos[i].try_lock()) {
-                cout << "[O]";
-                garfos[i].unlock();
-            } else {
-                cout << "[X]";
-            }
+            bool emUso = filosofos[i].estado == COMENDO || filosofos[(i + N - 1) % N].estado == COMENDO;
+            cout << (emUso ? "[X]" : "[O]");
         }
         cout << endl;
 
@@ -100,25 +362,89 @@ void monitor() {
     }
 }
 
-int main() {
-    // Inicializa gerador de números aleatórios
-    srand(time(nullptr));
-    
-    // Entrada de parâmetros
-    cout << "Digite o numero de filosofos: ";
-    cin >> N;
-    cout << "Digite a duracao da simulacao (s): ";
-    cin >> duracaoSimulacao;
-    cout << "Digite tempo de pensar (min ms max ms): ";
-    cin >> tempoPensarMin >> tempoPensarMax;
-    cout << "Digite tempo de comer (min ms max ms): ";
-    cin >> tempoComerMin >> tempoComerMax;
+#if defined(__cpp_impl_coroutine)
+atomic<int> corrotinasAtivas(0);
+
+// Filósofo como corrotina (estratégia ordem): pensar, comer e esperar garfo
+// suspendem a corrotina e liberam a thread do pool para outro filósofo. O
+// gerador fica no quadro da corrotina, que pode mudar de thread a cada retomada.
+Tarefa filosofoCorrotina(int id, PoolRoubo& pool, RodaTempo& roda, vector<MutexAssincrono>& garfosAssincronos) {
+    int primeiro = min(id, (id + 1) % N);
+    int segundo = max(id, (id + 1) % N);
+    seed_seq sequencia{semente, (unsigned)id};
+    minstd_rand geradorProprio(sequencia);
+
+    while (rodando) {
+        filosofos[id].estado = PENSANDO;
+        co_await esperar(roda, uniform_int_distribution<int>(tempoPensarMin, tempoPensarMax)(geradorProprio));
+
+        filosofos[id].estado = COM_FOME;
+        long long inicio = agoraUs();
+        co_await garfosAssincronos[primeiro].travar();
+        co_await garfosAssincronos[segundo].travar();
+        registrarFome(id, inicio);
+
+        filosofos[id].estado = COMENDO;
+        co_await esperar(roda, uniform_int_distribution<int>(tempoComerMin, tempoComerMax)(geradorProprio));
+        filosofos[id].refeicoes++;
+
+        garfosAssincronos[segundo].liberar(pool);
+        garfosAssincronos[primeiro].liberar(pool);
+    }
+    corrotinasAtivas--;
+}
+
+// Executa os N filósofos como corrotinas num pool do tamanho do número de núcleos
+void executarCorrotinas(bool exibirMonitor) {
+    vector<MutexAssincrono> garfosAssincronos(N);
+    PoolRoubo pool(max(1u, thread::hardware_concurrency()), nullptr);
+    RodaTempo roda(pool);
 
+    corrotinasAtivas = N;
+    for (int i = 0; i < N; i++) {
+        pool.agendar(filosofoCorrotina(i, pool, roda, garfosAssincronos).handle);
+    }
+    thread tmonitor;
+    if (exibirMonitor) tmonitor = thread(monitor);
+
+    auto inicio = chrono::steady_clock::now();
+    this_thread::sleep_for(chrono::seconds(duracaoSimulacao));
+    rodando = false;
+    duracaoMedida = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    // Cada corrotina termina depois da espera em que está
+    while (corrotinasAtivas > 0) this_thread::sleep_for(chrono::milliseconds(1));
+    roda.parar();
+    pool.parar();
+    if (tmonitor.joinable()) tmonitor.join();
+}
+#endif
+
+// Executa a simulação com a estratégia atual por duracaoSimulacao segundos
+void executar(bool exibirMonitor) {
     // Inicializa estruturas
-    garfos = vector<mutex>(N);
+    rodando = true;
     filosofos.resize(N);
     for (int i = 0; i < N; i++) {
-        filosofos[i] = {i, PENSANDO, 0};
+        filosofos[i] = {i, PENSANDO, 0, 0, 0};
+    }
+#if defined(__cpp_impl_coroutine)
+    if (modoCorrotinas) {
+        executarCorrotinas(exibirMonitor);
+        return;
+    }
+#endif
+    garfos = vector<mutex>(N);
+    garcom.reiniciar(N - 1);
+    caixas = vector<CaixaCM>(N);
+    for (int i = 0; i < N; i++) {
+        CaixaCM& c = caixas[i];
+        c.tenho[ESQ] = i < (i + N - 1) % N;   // garfo i fica com o menor de i-1 e i
+        c.tenho[DIR] = i < (i + 1) % N;       // garfo i+1 fica com o menor de i e i+1
+        c.sujo[ESQ] = c.sujo[DIR] = true;
+        c.pedido[ESQ] = c.pedido[DIR] = false;
+        c.pedidoEnviado[ESQ] = c.pedidoEnviado[DIR] = false;
+        c.comendo = false;
     }
 
     // Cria threads
@@ -126,21 +452,171 @@ int main() {
     for (int i = 0; i < N; i++) {
         threads.emplace_back(filosofo, i);
     }
-    thread tmonitor(monitor);
+    thread tmonitor;
+    if (exibirMonitor) tmonitor = thread(monitor);
 
     // Roda por tempo determinado
+    auto inicio = chrono::steady_clock::now();
     this_thread::sleep_for(chrono::seconds(duracaoSimulacao));
     rodando = false;
+    duracaoMedida = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    // Acorda quem espera mensagens (Chandy–Misra)
+    for (auto& c : caixas) {
+        lock_guard<mutex> lock(c.m);
+        c.cv.notify_all();
+    }
 
     // Aguarda encerramento
     for (auto &t : threads) t.join();
-    tmonitor.join();
+    if (tmonitor.joinable()) tmonitor.join();
+}
 
-    // Estatísticas finais
-    cout << "\nResumo Final:\n";
+// Vazão e justiça da execução que acabou de terminar
+struct Resultado {
+    long long total;
+    int menor, maior;
+    double porSegundo;
+    double jain;            // (soma)^2 / (N * soma dos quadrados): 1 = todos comem igual
+    double fomeMaximaMs, fomeMediaMs;
+};
+
+Resultado medir() {
+    Resultado r = {0, filosofos[0].refeicoes, filosofos[0].refeicoes, 0, 0, 0, 0};
+    double somaQuadrados = 0;
+    long long fomeTotal = 0, fomeMaxima = 0;
     for (int i = 0; i < N; i++) {
-        cout << "Filosofo " << i << " comeu " << filosofos[i].refeicoes << " vezes.\n";
+        r.total += filosofos[i].refeicoes;
+        r.menor = min(r.menor, filosofos[i].refeicoes);
+        r.maior = max(r.maior, filosofos[i].refeicoes);
+        somaQuadrados += (double)filosofos[i].refeicoes * filosofos[i].refeicoes;
+        fomeTotal += filosofos[i].fomeTotal;
+        fomeMaxima = max(fomeMaxima, filosofos[i].fomeMaxima);
+    }
+    r.porSegundo = duracaoMedida > 0 ? r.total / duracaoMedida : 0;
+    r.jain = somaQuadrados > 0 ? (double)r.total * r.total / (N * somaQuadrados) : 1;
+    r.fomeMaximaMs = fomeMaxima / 1000.0;
+    r.fomeMediaMs = r.total > 0 ? fomeTotal / 1000.0 / r.total : 0;
+    return r;
+}
+
+// Colunas de resultado da linha CSV (--csv e varredura)
+const char* CABECALHO_CSV = "refeicoes_total,refeicoes_por_s,refeicoes_min,refeicoes_max,jain,fome_max_ms";
+
+void imprimirUso(const char* programa) {
+    cout << "Uso: " << programa << "   (sem argumentos: parametros pedidos no terminal)\n"
+         << "     " << programa << " [--config arquivo] [--filosofos N] [--duracao S] [--pensar MIN-MAX]\n"
+         << "         [--comer MIN-MAX] [--estrategia E] [--benchmark] [--seed N] [--csv]\n"
+         << "  E = ordem | garcom | tentativa | chandy-misra; --benchmark roda todas em sequencia\n"
+         << "         [--modo threads|corrotinas]   (corrotinas: filosofos como corrotinas C++20 num pool\n"
+         << "          com roubo de trabalho, estrategia ordem; compilar com -std=c++20)\n"
+         << "     " << programa << " --varrer arquivo [--trabalhadores N] [--seed N] [--saida resultados.csv]\n"
+         << "  No arquivo de varredura cada linha e chave=v1,v2,...; roda todas as combinacoes." << endl;
+}
+
+int main(int argc, char** argv) {
+    Opcoes opcoes;
+    if (!lerArgumentos(argc, argv, opcoes)) {
+        imprimirUso(argv[0]);
+        return 1;
+    }
+    if (opcoes.count("ajuda")) {
+        imprimirUso(argv[0]);
+        return 0;
+    }
+    int varredura = talvezVarrer(argv[0], opcoes, CABECALHO_CSV);
+    if (varredura >= 0) return varredura;
+
+    bool modoCsv = opcoes.count("csv") > 0;
+    bool benchmark = opcoes.count("benchmark") > 0;
+    if (argc > 1) {
+        // Parâmetros pela linha de comando/arquivo (valores ausentes usam o padrão)
+        N = opcaoInt(opcoes, "filosofos", 5);
+        duracaoSimulacao = opcaoInt(opcoes, "duracao", 10);
+        tempoPensarMin = 100, tempoPensarMax = 300;
+        opcaoIntervalo(opcoes, "pensar", tempoPensarMin, tempoPensarMax);
+        tempoComerMin = 100, tempoComerMax = 300;
+        opcaoIntervalo(opcoes, "comer", tempoComerMin, tempoComerMax);
+        semente = opcoes.count("seed") ? (unsigned)opcaoInt(opcoes, "seed", 1) : (unsigned)time(nullptr);
+        if (opcoes.count("estrategia")) {
+            int e = 0;
+            while (e < NUM_ESTRATEGIAS && opcoes["estrategia"] != NOMES_ESTRATEGIA[e]) e++;
+            if (e == NUM_ESTRATEGIAS) {
+                cerr << "Erro: estrategia invalida: " << opcoes["estrategia"]
+                     << " (use ordem, garcom, tentativa ou chandy-misra)" << endl;
+                return 1;
+            }
+            estrategia = (Estrategia)e;
+        }
+        modoCorrotinas = opcoes.count("modo") && opcoes["modo"] == "corrotinas";
+    } else {
+        // Semente da execução (cada thread deriva a sua)
+        semente = (unsigned)time(nullptr);
+
+        // Entrada de parâmetros
+        cout << "Digite o numero de filosofos: ";
+        cin >> N;
+        cout << "Digite a duracao da simulacao (s): ";
+        cin >> duracaoSimulacao;
+        cout << "Digite tempo de pensar (min ms max ms): ";
+        cin >> tempoPensarMin >> tempoPensarMax;
+        cout << "Digite tempo de comer (min ms max ms): ";
+        cin >> tempoComerMin >> tempoComerMax;
     }
+    if (N < 2) N = 2;
+    if (tempoPensarMax < tempoPensarMin) swap(tempoPensarMin, tempoPensarMax);
+    if (tempoComerMax < tempoComerMin) swap(tempoComerMin, tempoComerMax);
+
+    if (modoCorrotinas) {
+#if defined(__cpp_impl_coroutine)
+        if (benchmark || estrategia != ORDEM) {
+            cerr << "Erro: o modo corrotinas usa so a estrategia ordem (sem --benchmark)." << endl;
+            return 1;
+        }
+#else
+        cerr << "Erro: o modo corrotinas requer compilar com -std=c++20." << endl;
+        return 1;
+#endif
+    }
+
+    // Benchmark: mesma configuração e semente para cada estratégia
+    if (benchmark) {
+        cout << "Filosofos: " << N << " | Duracao por estrategia: " << duracaoSimulacao << " s\n" << endl;
+        cout << left << setw(14) << "Estrategia" << right << setw(11) << "Refeicoes" << setw(13) << "Refeicoes/s"
+             << setw(9) << "Jain" << setw(12) << "Min-Max" << setw(15) << "Fome max ms" << setw(16) << "Fome media ms"
+             << endl;
+        for (int e = 0; e < NUM_ESTRATEGIAS; e++) {
+            estrategia = (Estrategia)e;
+            executar(false);
+            Resultado r = medir();
+            cout << left << setw(14) << NOMES_ESTRATEGIA[e] << right << setw(11) << r.total
+                 << fixed << setprecision(2) << setw(13) << r.porSegundo << setprecision(4) << setw(9) << r.jain
+                 << setw(12) << to_string(r.menor) + "-" + to_string(r.maior) << setprecision(1)
+                 << setw(15) << r.fomeMaximaMs << setw(16) << r.fomeMediaMs << endl;
+        }
+        return 0;
+    }
+
+    executar(!modoCsv);
+    Resultado r = medir();
+
+    if (modoCsv) {
+        cout << r.total << "," << fixed << setprecision(3) << r.porSegundo << ","
+             << r.menor << "," << r.maior << "," << setprecision(4) << r.jain << ","
+             << setprecision(3) << r.fomeMaximaMs << endl;
+        return 0;
+    }
+
+    // Estatísticas finais
+    cout << "\nResumo Final (" << NOMES_ESTRATEGIA[estrategia] << (modoCorrotinas ? ", corrotinas" : "") << "):\n";
+    for (int i = 0; i < N && N <= LIMITE_DETALHE; i++) {
+        cout << "Filosofo " << i << " comeu " << filosofos[i].refeicoes << " vezes."
+             << " | Fome maxima: " << filosofos[i].fomeMaxima / 1000 << " ms\n";
+    }
+    cout << "Filosofos: " << N << " | Refeicoes: " << r.total << " (" << r.menor << "-" << r.maior << " por filosofo)\n";
+    cout << "Refeicoes/s: " << fixed << setprecision(2) << r.porSegundo
+         << " | Indice de Jain: " << setprecision(4) << r.jain
+         << " | Fome media: " << setprecision(1) << r.fomeMediaMs << " ms" << endl;
 
     return 0;
-}
\ No newline at end of file
+}
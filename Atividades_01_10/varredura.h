@@ -0,0 +1,225 @@
+#ifndef VARREDURA_H
+#define VARREDURA_H
+
+// Parâmetros por linha de comando/arquivo e varredura de parâmetros em
+// paralelo, compartilhados pelos dois simuladores.
+//
+// Linha de comando: --chave valor (ou --chave=valor); --config arquivo lê
+// linhas "chave=valor" (# inicia comentário). Na varredura, cada chave do
+// arquivo pode ter uma lista separada por vírgulas; o produto cartesiano das
+// listas dá as execuções. Cada execução roda o próprio executável com --csv
+// e uma semente diferente (um processo por execução, já que os simuladores
+// usam estado global) e devolve uma linha CSV.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+#ifdef __linux__
+#include <unistd.h>
+#include <climits>
+#endif
+
+typedef std::map<std::string, std::string> Opcoes;
+
+inline std::string aparar(const std::string& texto) {
+    size_t ini = texto.find_first_not_of(" \t\r\n");
+    if (ini == std::string::npos) return "";
+    size_t fim = texto.find_last_not_of(" \t\r\n");
+    return texto.substr(ini, fim - ini + 1);
+}
+
+// Lê "chave=valor" por linha; retorna false se o arquivo não abrir
+inline bool lerConfiguracao(const std::string& caminho, Opcoes& opcoes) {
+    std::ifstream arquivo(caminho);
+    if (!arquivo.is_open()) {
+        std::cerr << "Erro: Nao foi possivel abrir " << caminho << std::endl;
+        return false;
+    }
+    std::string linha;
+    while (std::getline(arquivo, linha)) {
+        size_t comentario = linha.find('#');
+        if (comentario != std::string::npos) linha.erase(comentario);
+        size_t igual = linha.find('=');
+        if (igual == std::string::npos) continue;
+        std::string chave = aparar(linha.substr(0, igual));
+        if (!chave.empty()) opcoes[chave] = aparar(linha.substr(igual + 1));
+    }
+    return true;
+}
+
+// Converte argv em opções; chaves sem valor (--csv) recebem "1".
+// --config é expandido na hora (opções seguintes na linha de comando vencem)
+inline bool lerArgumentos(int argc, char** argv, Opcoes& opcoes) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            std::cerr << "Erro: Argumento invalido: " << arg << std::endl;
+            return false;
+        }
+        arg = arg.substr(2);
+        std::string valor = "1";
+        size_t igual = arg.find('=');
+        if (igual != std::string::npos) {
+            valor = arg.substr(igual + 1);
+            arg = arg.substr(0, igual);
+        } else if (i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0) {
+            valor = argv[++i];
+        }
+        if (arg == "config") {
+            if (!lerConfiguracao(valor, opcoes)) return false;
+        } else {
+            opcoes[arg] = valor;
+        }
+    }
+    return true;
+}
+
+inline int opcaoInt(const Opcoes& opcoes, const std::string& chave, int padrao) {
+    Opcoes::const_iterator it = opcoes.find(chave);
+    return it == opcoes.end() ? padrao : std::atoi(it->second.c_str());
+}
+
+// Intervalo "MIN-MAX" (ou um valor só, MIN = MAX)
+inline void opcaoIntervalo(const Opcoes& opcoes, const std::string& chave, int& minimo, int& maximo) {
+    Opcoes::const_iterator it = opcoes.find(chave);
+    if (it == opcoes.end()) return;
+    size_t traco = it->second.find('-', 1);
+    minimo = std::atoi(it->second.c_str());
+    maximo = traco == std::string::npos ? minimo : std::atoi(it->second.c_str() + traco + 1);
+}
+
+// Caminho do próprio executável, para relançá-lo nas execuções da varredura
+inline std::string caminhoExecutavel(const char* argv0) {
+#ifdef __linux__
+    char caminho[PATH_MAX];
+    ssize_t tamanho = readlink("/proc/self/exe", caminho, sizeof(caminho) - 1);
+    if (tamanho > 0) return std::string(caminho, tamanho);
+#endif
+    return argv0;
+}
+
+// Executa o produto cartesiano das listas do arquivo de varredura com
+// "trabalhadores" processos simultâneos e escreve o CSV (na ordem da grade)
+// em saida. Chaves do arquivo com um só valor também são repassadas.
+inline int executarVarredura(const std::string& executavel, const std::string& arquivoVarredura,
+                             const std::string& cabecalhoResultados, int trabalhadores,
+                             unsigned sementeBase, std::ostream& saida) {
+    Opcoes listas;
+    if (!lerConfiguracao(arquivoVarredura, listas)) return 1;
+
+    std::vector<std::string> chaves;
+    std::vector<std::vector<std::string>> valores;
+    for (Opcoes::const_iterator it = listas.begin(); it != listas.end(); ++it) {
+        std::vector<std::string> lista;
+        std::stringstream partes(it->second);
+        std::string valor;
+        while (std::getline(partes, valor, ',')) {
+            valor = aparar(valor);
+            if (!valor.empty()) lista.push_back(valor);
+        }
+        if (lista.empty()) continue;
+        chaves.push_back(it->first);
+        valores.push_back(lista);
+    }
+
+    // Produto cartesiano: a última chave varia mais rápido
+    std::vector<std::vector<std::string>> execucoes(1);
+    for (size_t k = 0; k < chaves.size(); k++) {
+        std::vector<std::vector<std::string>> proximas;
+        for (size_t e = 0; e < execucoes.size(); e++) {
+            for (size_t v = 0; v < valores[k].size(); v++) {
+                proximas.push_back(execucoes[e]);
+                proximas.back().push_back(valores[k][v]);
+            }
+        }
+        execucoes.swap(proximas);
+    }
+
+    if (trabalhadores < 1) trabalhadores = 1;
+    std::cerr << "Varredura: " << execucoes.size() << " execucao(oes), " << trabalhadores
+              << " em paralelo" << std::endl;
+
+    std::vector<std::string> resultados(execucoes.size());
+    std::atomic<size_t> proxima(0);
+    std::atomic<int> falhas(0);
+    auto trabalhador = [&]() {
+        for (size_t i = proxima++; i < execucoes.size(); i = proxima++) {
+            std::string comando = "\"" + executavel + "\" --csv --seed " + std::to_string(sementeBase + i);
+            for (size_t k = 0; k < chaves.size(); k++) {
+                comando += " --" + chaves[k] + " \"" + execucoes[i][k] + "\"";
+            }
+            FILE* processo = popen(comando.c_str(), "r");
+            if (!processo) {
+                falhas++;
+                continue;
+            }
+            std::string linha, ultima;
+            char buffer[512];
+            while (std::fgets(buffer, sizeof(buffer), processo)) {
+                linha += buffer;
+                if (!linha.empty() && linha.back() == '\n') {
+                    if (aparar(linha).size() > 0) ultima = aparar(linha);
+                    linha.clear();
+                }
+            }
+            if (!aparar(linha).empty()) ultima = aparar(linha);
+            if (pclose(processo) != 0 || ultima.empty()) falhas++;
+            resultados[i] = ultima;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < trabalhadores; t++) threads.emplace_back(trabalhador);
+    for (auto& t : threads) t.join();
+
+    saida << "seed";
+    for (size_t k = 0; k < chaves.size(); k++) saida << "," << chaves[k];
+    saida << "," << cabecalhoResultados << "\n";
+    for (size_t i = 0; i < execucoes.size(); i++) {
+        saida << sementeBase + i;
+        for (size_t k = 0; k < chaves.size(); k++) saida << "," << execucoes[i][k];
+        saida << "," << resultados[i] << "\n";
+    }
+    saida.flush();
+
+    if (falhas > 0) {
+        std::cerr << "Aviso: " << falhas << " execucao(oes) falharam." << std::endl;
+    }
+    return falhas > 0 ? 1 : 0;
+}
+
+// Trata --varrer/--trabalhadores/--saida/--seed; retorna -1 se não for varredura
+inline int talvezVarrer(const char* argv0, const Opcoes& opcoes, const std::string& cabecalhoResultados) {
+    Opcoes::const_iterator it = opcoes.find("varrer");
+    if (it == opcoes.end()) return -1;
+
+    int trabalhadores = opcaoInt(opcoes, "trabalhadores", (int)std::thread::hardware_concurrency());
+    unsigned semente = (unsigned)opcaoInt(opcoes, "seed", 1);
+    Opcoes::const_iterator arquivoSaida = opcoes.find("saida");
+    if (arquivoSaida != opcoes.end()) {
+        std::ofstream saida(arquivoSaida->second);
+        if (!saida.is_open()) {
+            std::cerr << "Erro: Nao foi possivel criar " << arquivoSaida->second << std::endl;
+            return 1;
+        }
+        return executarVarredura(caminhoExecutavel(argv0), it->second, cabecalhoResultados,
+                                 trabalhadores, semente, saida);
+    }
+    return executarVarredura(caminhoExecutavel(argv0), it->second, cabecalhoResultados,
+                             trabalhadores, semente, std::cout);
+}
+
+#endif // VARREDURA_H
@@ -0,0 +1,319 @@
+#include "async_io.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <sys/uio.h>
+    #if __has_include(<linux/io_uring.h>)
+        #include <linux/io_uring.h>
+        #define HAVE_IO_URING 1
+    #endif
+#endif
+
+using namespace std;
+
+// ============================================================================
+// io_uring sem liburing
+// ============================================================================
+// O kernel e o processo compartilham dois anéis: no de submissão (SQ) o
+// processo escreve SQEs e avança o tail; no de conclusão (CQ) o kernel
+// escreve CQEs e o processo avança o head. Cada lado publica seu índice com
+// store-release e lê o do outro com load-acquire. Um io_uring_enter submete
+// o lote e espera as conclusões. Usa READV/WRITEV (kernel 5.1+); leituras e
+// escritas parciais são reenviadas com o restante.
+// ============================================================================
+
+#ifdef HAVE_IO_URING
+static int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int ioUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+}
+#endif
+
+AsyncIOEngine::AsyncIOEngine()
+    : fd(-1), depth(0), ringFd(-1), sqRing(nullptr), cqRing(nullptr), sqes(nullptr),
+      sqRingSize(0), cqRingSize(0), sqesSize(0), sqHead(nullptr), sqTail(nullptr), sqMask(nullptr),
+      sqArray(nullptr), sqEntries(0), cqHead(nullptr), cqTail(nullptr), cqMask(nullptr), cqes(nullptr),
+      ringFailed(false), outstanding(0), failed(false), stopping(false) {}
+
+AsyncIOEngine::~AsyncIOEngine() {
+    close();
+}
+
+const char* AsyncIOEngine::backendName() const {
+    if (fd < 0) return "desligado";
+    return ringFd >= 0 ? "io_uring" : "pool de threads";
+}
+
+bool AsyncIOEngine::open(const string& path, bool direct, unsigned queueDepth) {
+    close();
+#if defined(__linux__)
+    int flags = O_RDWR;
+#ifdef O_DIRECT
+    if (direct) flags |= O_DIRECT;
+#endif
+    fd = ::open(path.c_str(), flags);
+    if (fd < 0) return false;
+
+    depth = max(1u, min(queueDepth, 4096u));
+    if (setupRing()) return true;
+
+    // Sem io_uring (kernel antigo ou bloqueado): uma thread por slot da fila
+    unsigned threads = min(depth, max(1u, thread::hardware_concurrency()) * 4);
+    stopping = false;
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back(&AsyncIOEngine::poolWorker, this);
+    }
+    return true;
+#else
+    (void)path;
+    (void)direct;
+    (void)queueDepth;
+    return false;
+#endif
+}
+
+void AsyncIOEngine::close() {
+    if (!workers.empty()) {
+        {
+            lock_guard<mutex> lock(poolMutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (thread& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+    teardownRing();
+#if defined(__linux__)
+    if (fd >= 0) {
+        ::close(fd);
+    }
+#endif
+    fd = -1;
+}
+
+bool AsyncIOEngine::setupRing() {
+#ifdef HAVE_IO_URING
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringFd = ioUringSetup(depth, &params);
+    if (ringFd < 0) {
+        ringFd = -1;
+        return false;
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        sqRingSize = cqRingSize = max(sqRingSize, cqRingSize);
+    }
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        sqRing = nullptr;
+        teardownRing();
+        return false;
+    }
+    cqRing = singleMap ? sqRing
+                       : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+                              IORING_OFF_CQ_RING);
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (cqRing == MAP_FAILED || sqes == MAP_FAILED) {
+        if (cqRing == MAP_FAILED) cqRing = nullptr;
+        if (sqes == MAP_FAILED) sqes = nullptr;
+        teardownRing();
+        return false;
+    }
+
+    char* sq = static_cast<char*>(sqRing);
+    char* cq = static_cast<char*>(cqRing);
+    sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sqEntries = params.sq_entries;
+    cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = cq + params.cq_off.cqes;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AsyncIOEngine::teardownRing() {
+#ifdef HAVE_IO_URING
+    if (sqes) munmap(sqes, sqesSize);
+    if (cqRing && cqRing != sqRing) munmap(cqRing, cqRingSize);
+    if (sqRing) munmap(sqRing, sqRingSize);
+    if (ringFd >= 0) ::close(ringFd);
+#endif
+    sqes = sqRing = cqRing = nullptr;
+    ringFd = -1;
+    ringFailed = false;
+}
+
+bool AsyncIOEngine::submitAndWait(vector<IORequest>& requests) {
+    if (fd < 0) return false;
+    if (requests.empty()) return true;
+    return ringFd >= 0 ? submitRing(requests) : submitPool(requests);
+}
+
+bool AsyncIOEngine::submitRing(vector<IORequest>& requests) {
+#ifdef HAVE_IO_URING
+    if (ringFailed) return false;
+    io_uring_sqe* sqeArray = static_cast<io_uring_sqe*>(sqes);
+    io_uring_cqe* cqeArray = static_cast<io_uring_cqe*>(cqes);
+    vector<iovec> iovecs(requests.size());
+
+    // Índices das requisições ainda não concluídas (inclui reenvios parciais)
+    deque<size_t> queue;
+    for (size_t i = 0; i < requests.size(); i++) queue.push_back(i);
+    unsigned inFlight = 0;      // Consumidas pelo kernel e ainda sem conclusão
+    unsigned unsubmitted = 0;   // No anel de submissão, ainda não consumidas
+    unsigned window = min(depth, sqEntries);
+    bool ok = true;
+
+    // Consome as conclusões disponíveis; com requeue, reenvia o restante das parciais
+    auto reap = [&](bool requeue) {
+        unsigned head = *cqHead;
+        unsigned cqTailValue = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != cqTailValue; head++) {
+            const io_uring_cqe& cqe = cqeArray[head & *cqMask];
+            IORequest& request = requests[cqe.user_data];
+            inFlight--;
+            if (cqe.res <= 0) {
+                ok = false;     // Erro (-errno) ou fim do arquivo inesperado
+                continue;
+            }
+            uint32_t done = static_cast<uint32_t>(cqe.res);
+            if (done < request.length && requeue) {
+                request.offset += done;
+                request.buffer += done;
+                request.length -= done;
+                queue.push_back(cqe.user_data);
+            }
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    };
+
+    while (ok && (!queue.empty() || inFlight > 0 || unsubmitted > 0)) {
+        // Preenche a fila de submissão até a profundidade configurada
+        unsigned tail = *sqTail;
+        while (!queue.empty() && inFlight + unsubmitted < window) {
+            size_t index = queue.front();
+            queue.pop_front();
+            IORequest& request = requests[index];
+            iovecs[index].iov_base = request.buffer;
+            iovecs[index].iov_len = request.length;
+
+            unsigned slot = tail & *sqMask;
+            io_uring_sqe& sqe = sqeArray[slot];
+            memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = request.write ? IORING_OP_WRITEV : IORING_OP_READV;
+            sqe.fd = fd;
+            sqe.off = request.offset;
+            sqe.addr = reinterpret_cast<uint64_t>(&iovecs[index]);
+            sqe.len = 1;
+            sqe.user_data = index;
+            sqArray[slot] = slot;
+            tail++;
+            unsubmitted++;
+        }
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+
+        // Submete e espera pelo menos uma conclusão. O kernel pode consumir
+        // só parte das SQEs: só as consumidas (result) passam a estar em voo
+        int result;
+        do {
+            result = ioUringEnter(ringFd, unsubmitted, 1, IORING_ENTER_GETEVENTS);
+        } while (result < 0 && errno == EINTR);
+        if (result < 0) {
+            ok = false;
+            break;
+        }
+        inFlight += static_cast<unsigned>(result);
+        unsubmitted -= static_cast<unsigned>(result);
+        reap(true);
+    }
+    if (ok) return true;
+
+    // Erro: as SQEs já consumidas apontam para iovecs e para os buffers do
+    // chamador, então só se retorna depois de todas concluírem. Se o
+    // io_uring_enter também falhar, espera as conclusões olhando o anel
+    while (inFlight > 0) {
+        reap(false);
+        if (inFlight == 0) break;
+        if (ioUringEnter(ringFd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+    // SQEs não consumidas continuam no anel com endereços que vão deixar de
+    // valer: o anel não pode mais ser usado
+    ringFailed = true;
+    return false;
+#else
+    (void)requests;
+    return false;
+#endif
+}
+
+bool AsyncIOEngine::submitPool(vector<IORequest>& requests) {
+    unique_lock<mutex> lock(poolMutex);
+    failed = false;
+    outstanding = requests.size();
+    for (IORequest& request : requests) {
+        pending.push_back(&request);
+    }
+    workAvailable.notify_all();
+    batchDone.wait(lock, [this] { return outstanding == 0; });
+    return !failed;
+}
+
+void AsyncIOEngine::poolWorker() {
+#if defined(__linux__)
+    unique_lock<mutex> lock(poolMutex);
+    while (true) {
+        workAvailable.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (stopping) return;
+        IORequest* request = pending.front();
+        pending.pop_front();
+        lock.unlock();
+
+        // Repete até completar (pread/pwrite podem transferir menos que o pedido)
+        bool ok = true;
+        uint32_t done = 0;
+        while (done < request->length) {
+            ssize_t result = request->write
+                ? ::pwrite(fd, request->buffer + done, request->length - done, request->offset + done)
+                : ::pread(fd, request->buffer + done, request->length - done, request->offset + done);
+            if (result < 0 && errno == EINTR) continue;
+            if (result <= 0) {
+                ok = false;
+                break;
+            }
+            done += static_cast<uint32_t>(result);
+        }
+
+        lock.lock();
+        if (!ok) failed = true;
+        if (--outstanding == 0) {
+            batchDone.notify_all();
+        }
+    }
+#endif
+}
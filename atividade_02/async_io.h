@@ -0,0 +1,82 @@
+#ifndef ASYNC_IO_H
+#define ASYNC_IO_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Uma leitura ou escrita posicional de um lote
+struct IORequest {
+    bool     write;
+    uint64_t offset;
+    char*    buffer;
+    uint32_t length;
+};
+
+// Motor de I/O assíncrono sobre um arquivo: um lote inteiro de requisições é
+// submetido de uma vez e o chamador espera todas terminarem. Usa io_uring
+// (syscalls diretas, sem liburing) quando o kernel permite; senão, um pool de
+// threads fazendo pread/pwrite. queueDepth limita as requisições em voo.
+class AsyncIOEngine {
+public:
+    AsyncIOEngine();
+    ~AsyncIOEngine();
+
+    // Abre path (com O_DIRECT se direct) e prepara o backend
+    bool open(const std::string& path, bool direct, unsigned queueDepth);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+    unsigned queueDepth() const { return depth; }
+    const char* backendName() const;
+
+    // Executa todas as requisições; false se alguma falhar
+    bool submitAndWait(std::vector<IORequest>& requests);
+
+private:
+    AsyncIOEngine(const AsyncIOEngine&);
+    AsyncIOEngine& operator=(const AsyncIOEngine&);
+
+    bool setupRing();
+    void teardownRing();
+    bool submitRing(std::vector<IORequest>& requests);
+    bool submitPool(std::vector<IORequest>& requests);
+    void poolWorker();
+
+    int fd;
+    unsigned depth;
+
+    // io_uring: anéis mapeados do kernel
+    int ringFd;
+    void* sqRing;
+    void* cqRing;
+    void* sqes;
+    size_t sqRingSize;
+    size_t cqRingSize;
+    size_t sqesSize;
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned* sqMask;
+    unsigned* sqArray;
+    unsigned sqEntries;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned* cqMask;
+    void* cqes;
+    bool ringFailed;            // Erro com SQEs não consumidas no anel: não reutilizar
+
+    // Fallback: pool de threads com fila de requisições
+    std::vector<std::thread> workers;
+    std::deque<IORequest*> pending;
+    std::mutex poolMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable batchDone;
+    size_t outstanding;
+    bool failed;
+    bool stopping;
+};
+
+#endif // ASYNC_IO_H
@@ -0,0 +1,100 @@
+#include "bench.h"
+#include "fat16.h"
+#include "trace.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+// Carga de trabalho fixa (semente constante) para comparar geometrias:
+// tamanhos log-uniformes entre 64 B e 256 KiB, até ocupar metade da imagem
+static vector<uint32_t> makeWorkload(uint64_t capacity, uint16_t maxFiles) {
+    mt19937 rng(42);
+    uniform_real_distribution<double> exponent(log(64.0), log(256.0 * 1024));
+    vector<uint32_t> sizes;
+    uint64_t total = 0;
+    while (sizes.size() < maxFiles) {
+        uint32_t size = static_cast<uint32_t>(exp(exponent(rng)));
+        if (total + size > capacity / 2) break;
+        sizes.push_back(size);
+        total += size;
+    }
+    return sizes;
+}
+
+int benchmarkGeometry(uint32_t totalMB, const string& scratchImage) {
+    const uint16_t rootEntries = 512;
+    vector<uint32_t> sizes = makeWorkload(uint64_t(totalMB) * 1024 * 1024, rootEntries - 1);
+    uint64_t payload = 0;
+    for (uint32_t size : sizes) payload += size;
+
+    cout << "\n========== BENCHMARK DE GEOMETRIA (" << totalMB << " MB) ==========\n";
+    cout << "Carga: " << sizes.size() << " arquivos, " << payload / 1024 << " KiB de dados\n\n";
+    cout << right << setw(5) << "spc" << setw(9) << "cluster" << setw(10) << "slack"
+         << setw(10) << "slack %" << setw(14) << "clust/arq" << setw(14) << "grava MB/s"
+         << setw(12) << "le MB/s" << "\n";
+
+    vector<char> data;
+    for (uint8_t spc = 1; spc <= 64; spc *= 2) {
+        FormatOptions options = { uint64_t(totalMB) * 1024 * 1024, spc, rootEntries, 2, "" };
+        uint32_t clusterSize = spc * 512;
+
+        // Formatação e operações ficam silenciosas; o relatório vai para o cout original
+        NullBuffer nullBuffer;
+        streambuf* oldCout = cout.rdbuf(&nullBuffer);
+        streambuf* oldCerr = cerr.rdbuf(&nullBuffer);
+
+        bool ok = FAT16Manager::formatImage(scratchImage, options);
+        double writeSeconds = 0, readSeconds = 0;
+        uint64_t slack = 0, clusters = 0;
+        if (ok) {
+            FAT16Manager fat16(scratchImage);
+            ok = fat16.initialize();
+
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            for (size_t i = 0; ok && i < sizes.size(); i++) {
+                data.assign(sizes[i], static_cast<char>('A' + i % 26));
+                char name[16];
+                snprintf(name, sizeof(name), "F%07u.BIN", static_cast<unsigned>(i));
+                ok = fat16.createFileFromBuffer(name, data.data(), sizes[i]);
+            }
+            chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+            for (const DirectoryEntry& entry : fat16.getFileEntries()) {
+                ok = ok && fat16.readFile(FAT16Manager::getFileName(entry), data);
+            }
+            chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+
+            writeSeconds = chrono::duration<double>(t1 - t0).count();
+            readSeconds = chrono::duration<double>(t2 - t1).count();
+            for (uint32_t size : sizes) {
+                uint64_t used = (uint64_t(size) + clusterSize - 1) / clusterSize;
+                clusters += used;
+                slack += used * clusterSize - size;
+            }
+        }
+
+        cout.rdbuf(oldCout);
+        cerr.rdbuf(oldCerr);
+
+        cout << setw(5) << int(spc) << setw(9) << clusterSize;
+        if (!ok) {
+            cout << "   geometria inválida ou imagem cheia\n";
+            continue;
+        }
+        double mb = payload / (1024.0 * 1024.0);
+        cout << setw(10) << slack / 1024 << "K" << fixed << setprecision(1)
+             << setw(9) << 100.0 * slack / (payload + slack)
+             << setw(14) << double(clusters) / sizes.size()
+             << setw(14) << (writeSeconds > 0 ? mb / writeSeconds : 0.0)
+             << setw(12) << (readSeconds > 0 ? mb / readSeconds : 0.0) << "\n";
+    }
+    cout << "========================================\n" << endl;
+
+    remove(scratchImage.c_str());
+    return 0;
+}
@@ -0,0 +1,13 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdint>
+#include <string>
+
+// Benchmark de geometria: formata uma imagem temporária de totalMB megabytes
+// com cada valor de setores por cluster (1..64), grava e lê a mesma carga de
+// arquivos e imprime desperdício de slack, leituras por arquivo e vazão (MB/s).
+// A imagem temporária é sobrescrita a cada rodada e removida no final.
+int benchmarkGeometry(uint32_t totalMB, const std::string& scratchImage);
+
+#endif // BENCH_H
@@ -0,0 +1,67 @@
+#include "buffer_pool.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+    #include <malloc.h>
+#endif
+
+using namespace std;
+
+static char* allocateAligned(size_t size) {
+#ifdef _WIN32
+    void* memory = _aligned_malloc(size, AlignedBufferPool::ALIGNMENT);
+#else
+    void* memory = nullptr;
+    if (posix_memalign(&memory, AlignedBufferPool::ALIGNMENT, size) != 0) {
+        memory = nullptr;
+    }
+#endif
+    if (!memory) throw bad_alloc();
+    return static_cast<char*>(memory);
+}
+
+static void freeAligned(char* buffer) {
+#ifdef _WIN32
+    _aligned_free(buffer);
+#else
+    free(buffer);
+#endif
+}
+
+AlignedBufferPool::AlignedBufferPool() : size(ALIGNMENT) {}
+
+AlignedBufferPool::~AlignedBufferPool() {
+    clear();
+}
+
+void AlignedBufferPool::reset(size_t bufferSize) {
+    lock_guard<mutex> lock(poolMutex);
+    clear();
+    size = (bufferSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+void AlignedBufferPool::clear() {
+    for (char* buffer : freeBuffers) {
+        freeAligned(buffer);
+    }
+    freeBuffers.clear();
+}
+
+// Reaproveita um buffer livre; só aloca quando todos estão emprestados
+char* AlignedBufferPool::acquire() {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        if (!freeBuffers.empty()) {
+            char* buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+            return buffer;
+        }
+    }
+    return allocateAligned(size);
+}
+
+void AlignedBufferPool::release(char* buffer) {
+    lock_guard<mutex> lock(poolMutex);
+    freeBuffers.push_back(buffer);
+}
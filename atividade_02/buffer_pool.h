@@ -0,0 +1,52 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Pool de buffers alinhados e reutilizáveis, todos do mesmo tamanho (um
+// cluster). O alinhamento atende O_DIRECT, que exige endereço, offset e
+// tamanho múltiplos do bloco lógico do dispositivo.
+class AlignedBufferPool {
+public:
+    static const size_t ALIGNMENT = 4096;
+
+    AlignedBufferPool();
+    ~AlignedBufferPool();
+
+    // Define o tamanho dos buffers (arredondado para ALIGNMENT) e libera os antigos;
+    // só pode ser chamado sem buffers emprestados
+    void reset(size_t bufferSize);
+    size_t bufferSize() const { return size; }
+
+    char* acquire();
+    void release(char* buffer);
+
+private:
+    AlignedBufferPool(const AlignedBufferPool&);
+    AlignedBufferPool& operator=(const AlignedBufferPool&);
+    void clear();
+
+    std::mutex poolMutex;
+    std::vector<char*> freeBuffers;
+    size_t size;
+};
+
+// Empresta um buffer do pool e devolve no fim do escopo
+class PooledBuffer {
+public:
+    explicit PooledBuffer(AlignedBufferPool& owner) : pool(owner), buffer(owner.acquire()) {}
+    ~PooledBuffer() { pool.release(buffer); }
+
+    char* data() const { return buffer; }
+
+private:
+    PooledBuffer(const PooledBuffer&);
+    PooledBuffer& operator=(const PooledBuffer&);
+
+    AlignedBufferPool& pool;
+    char* buffer;
+};
+
+#endif // BUFFER_POOL_H
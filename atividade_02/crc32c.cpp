@@ -0,0 +1,127 @@
+#include "crc32c.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #include <nmmintrin.h>
+    #define CRC32C_X86 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+    #define CRC32C_ARM 1
+#endif
+
+// Polinômio de Castagnoli na forma refletida
+#define CRC32C_POLY 0x82F63B78u
+
+// Tabelas para o método slicing-by-8 (processa 8 bytes por iteração)
+static uint32_t crcTable[8][256];
+
+static bool initTables() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+        }
+        crcTable[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            crcTable[t][i] = (crcTable[t - 1][i] >> 8) ^ crcTable[0][crcTable[t - 1][i] & 0xFF];
+        }
+    }
+    return true;
+}
+
+static const bool tablesReady = initTables();
+
+static uint32_t crc32cSoftware(uint32_t crc, const unsigned char* p, size_t length) {
+    while (length >= 8) {
+        uint32_t low, high;
+        memcpy(&low, p, 4);
+        memcpy(&high, p + 4, 4);
+        low ^= crc;
+        crc = crcTable[7][low & 0xFF] ^ crcTable[6][(low >> 8) & 0xFF] ^
+              crcTable[5][(low >> 16) & 0xFF] ^ crcTable[4][low >> 24] ^
+              crcTable[3][high & 0xFF] ^ crcTable[2][(high >> 8) & 0xFF] ^
+              crcTable[1][(high >> 16) & 0xFF] ^ crcTable[0][high >> 24];
+        p += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = (crc >> 8) ^ crcTable[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(CRC32C_X86)
+// Compilada para SSE4.2 mesmo sem -msse4.2; só é chamada se a CPU suportar
+__attribute__((target("sse4.2")))
+static uint32_t crc32cHardware(uint32_t crc, const unsigned char* p, size_t length) {
+#if defined(__x86_64__)
+    uint64_t crc64 = crc;
+    while (length >= 8) {
+        uint64_t value;
+        memcpy(&value, p, 8);
+        crc64 = _mm_crc32_u64(crc64, value);
+        p += 8;
+        length -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    while (length >= 4) {
+        uint32_t value;
+        memcpy(&value, p, 4);
+        crc = _mm_crc32_u32(crc, value);
+        p += 4;
+        length -= 4;
+    }
+    while (length--) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+
+static bool detectHardware() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+}
+#elif defined(CRC32C_ARM)
+static uint32_t crc32cHardware(uint32_t crc, const unsigned char* p, size_t length) {
+    while (length >= 8) {
+        uint64_t value;
+        memcpy(&value, p, 8);
+        crc = __crc32cd(crc, value);
+        p += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = __crc32cb(crc, *p++);
+    }
+    return crc;
+}
+
+static bool detectHardware() {
+    return true;
+}
+#else
+static bool detectHardware() {
+    return false;
+}
+#endif
+
+static const bool hardwareAvailable = detectHardware();
+
+bool crc32cHardwareAvailable() {
+    return hardwareAvailable;
+}
+
+uint32_t crc32c(const void* data, size_t length, uint32_t crc) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#if defined(CRC32C_X86) || defined(CRC32C_ARM)
+    if (hardwareAvailable) {
+        return ~crc32cHardware(crc, p, length);
+    }
+#endif
+    (void)tablesReady;
+    return ~crc32cSoftware(crc, p, length);
+}
@@ -0,0 +1,16 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstdint>
+#include <cstddef>
+
+// CRC32C (polinômio de Castagnoli, o mesmo usado por iSCSI, ext4 e btrfs)
+// Encadeável: crc32c(b, nb, crc32c(a, na)) == crc32c(a + b, na + nb)
+// Usa a instrução crc32 do SSE4.2 (x86) ou a extensão CRC do ARMv8 quando
+// a CPU suporta; caso contrário, tabela slicing-by-8 em software.
+uint32_t crc32c(const void* data, size_t length, uint32_t crc = 0);
+
+// Indica se a implementação em hardware está sendo usada
+bool crc32cHardwareAvailable();
+
+#endif // CRC32C_H
@@ -3,26 +3,116 @@
 #include <iomanip>
 #include <algorithm>
 #include <ctime>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+#include "search.h"
+#include "crc32c.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
 
 #ifdef _WIN32
     #include <windows.h>
 #else
     #include <sys/stat.h>
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <dirent.h>
 #endif
 
 using namespace std;
 
+// Registra uma chamada pública no trace, se a gravação estiver ativa
+// Mede o tempo entre a construção e a destruição do objeto (RAII),
+// então cobre todos os caminhos de retorno do método instrumentado.
+// Os argumentos são copiados: temporários (valores padrão, literais) não
+// vivem até o destrutor. Só a chamada mais externa é registrada: uma
+// operação feita por dentro de outra (ex.: checkFATCopies na montagem)
+// seria reexecutada duas vezes no replay
+class TraceGuard {
+public:
+    TraceGuard(FAT16Manager& m, TraceOp traceOp, const string& a1 = string(), const string& a2 = string())
+        : ok(false), manager(m), op(traceOp), active(m.traceFile.is_open() && m.traceDepth == 0) {
+        manager.traceDepth++;
+        if (active) {
+            arg1 = a1;
+            arg2 = a2;
+            start = chrono::steady_clock::now();
+        }
+    }
+
+    ~TraceGuard() {
+        manager.traceDepth--;
+        if (!active) return;
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+        TraceRecordHeader rec;
+        rec.op = op;
+        rec.ok = ok ? 1 : 0;
+        rec.arg1Len = static_cast<uint16_t>(min(arg1.size(), size_t(0xFFFF)));
+        rec.arg2Len = static_cast<uint16_t>(min(arg2.size(), size_t(0xFFFF)));
+        rec.startNs = chrono::duration_cast<chrono::nanoseconds>(start - manager.traceStart).count();
+        rec.durationNs = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+
+        manager.traceFile.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+        manager.traceFile.write(arg1.data(), rec.arg1Len);
+        manager.traceFile.write(arg2.data(), rec.arg2Len);
+    }
+
+    bool ok;    // Marcado pelo método antes de retornar com sucesso
+
+private:
+    FAT16Manager& manager;
+    TraceOp op;
+    bool active;
+    string arg1;
+    string arg2;
+    chrono::steady_clock::time_point start;
+};
+
 // Construtor da classe FAT16Manager
 FAT16Manager::FAT16Manager(const string& imagePath) : imageFileName(imagePath) {
     fatStartSector = 0;
     rootDirStartSector = 0;
     dataStartSector = 0;
     rootDirSectors = 0;
+    deltaDataOffset = 0;
+    discardEnabled = false;
+    discardFd = -1;
+    directFd = -1;
+    autoCompactPercent = 0;
+    verifyFATOnMount = false;
+    traceDepth = 0;
+    mountFATStatus = FAT16_OK;
+    batchDepth = 0;
+    batchDirty = false;
+    outputFormat = OUTPUT_TEXT;
+    accessTimeEnabled = true;
+    accessFlushSeconds = 0;
 }
 
 // Destrutor da classe FAT16Manager
 FAT16Manager::~FAT16Manager() {
+    // Um lote ainda aberto é gravado antes de fechar a imagem
+    if (batchDepth > 0) {
+        batchDepth = 1;
+        commitBatch();
+    }
+    // Datas de acesso pendentes são gravadas na desmontagem
+    if (imageFile.is_open()) {
+        flushAccessTimes();
+    }
+    stopTrace();
+    setDiscardMode(false);
+    setDirectIO(false);
+    setAsyncIO(false);
+    if (deltaFile.is_open()) {
+        deltaFile.close();
+    }
     if (imageFile.is_open()) {
         imageFile.close();
     }
@@ -32,46 +122,139 @@ FAT16Manager::~FAT16Manager() {
 // Monta o sistema de arquivos, carregando as estruturas de controle na memória
 // Similar ao processo de montagem (mount) de um disco em sistemas Unix/Linux
 bool FAT16Manager::initialize() {
+    TraceGuard trace(*this, TRACE_INITIALIZE, imageFileName);
+    string failure;
+    if (mountImage(failure) != FAT16_OK) {
+        cerr << "Erro: " << failure << endl;
+        return false;
+    }
+    if (verifyFATOnMount) {
+        printFATCheckReport(mountFATStatus, mountFATReport);
+        if (mountFATStatus != FAT16_OK) {
+            cerr << "Aviso: Cópias da FAT inconsistentes." << endl;
+        }
+    }
+    trace.ok = true;
+    return true;
+}
+
+// Montagem sem saída no console (API da biblioteca)
+FAT16Status FAT16Manager::mount() {
+    TraceGuard trace(*this, TRACE_INITIALIZE, imageFileName);
+    string failure;
+    FAT16Status status = mountImage(failure);
+    trace.ok = (status == FAT16_OK);
+    return status;
+}
+
+// Núcleo da montagem: em caso de erro, failure descreve a etapa que falhou
+FAT16Status FAT16Manager::mountImage(string& failure) {
     // Abre o arquivo de imagem em modo binário (leitura e escrita)
     // Simula a abertura de um dispositivo de bloco pelo driver de disco
-    imageFile.open(imageFileName, ios::in | ios::out | ios::binary);
+    // No modo overlay a imagem base é somente leitura: as escritas vão para o delta
+    ios::openmode mode = ios::in | ios::binary;
+    if (deltaFileName.empty()) {
+        mode |= ios::out;
+    }
+    imageFile.open(imageFileName, mode);
     if (!imageFile.is_open()) {
-        cerr << "Erro: Não foi possível abrir a imagem do disco: " << imageFileName << endl;
-        return false;
+        failure = "Não foi possível abrir a imagem do disco: " + imageFileName;
+        return FAT16_IO_ERROR;
     }
     
     // Carrega o Boot Sector (setor 0)
     // Lê os metadados do sistema de arquivos (similar ao superbloco em ext4)
     if (!loadBootSector()) {
-        cerr << "Erro: Falha ao carregar o Boot Sector" << endl;
-        return false;
+        failure = "Falha ao carregar o Boot Sector";
+        return FAT16_IO_ERROR;
+    }
+    
+    // Geometria impossível (arquivo que não é uma imagem FAT16) causaria
+    // divisões por zero e leituras fora da imagem mais adiante
+    uint16_t bytesPerSector = bootSector.bytesPerSector;
+    if (bytesPerSector < 512 || bytesPerSector > 4096 || (bytesPerSector & (bytesPerSector - 1)) != 0 ||
+        bootSector.sectorsPerCluster == 0 || bootSector.numFATs == 0 || bootSector.sectorsPerFAT == 0) {
+        failure = "Boot Sector inválido (a imagem não parece ser FAT16)";
+        return FAT16_CORRUPTED;
+    }
+    
+    // Buffers de cluster reutilizados por leituras e escritas de dados
+    bufferPool.reset(bootSector.sectorsPerCluster * bootSector.bytesPerSector);
+    
+    // Abre (ou cria vazio) o arquivo delta do overlay antes de ler FAT e diretório,
+    // pois setores já modificados em execuções anteriores devem vir do delta
+    if (!deltaFileName.empty() && !openOverlay()) {
+        failure = "Falha ao abrir o arquivo delta do overlay: " + deltaFileName;
+        return FAT16_IO_ERROR;
+    }
+    
+    // Carrega o diretório raiz antes da FAT quando as cópias da FAT serão
+    // verificadas: a validação das cadeias precisa das entradas de arquivo
+    if (verifyFATOnMount && !loadRootDirectory()) {
+        failure = "Falha ao carregar o diretório raiz";
+        return FAT16_IO_ERROR;
+    }
+    
+    // Confere as cópias da FAT e corrige setores divergentes antes de usá-la.
+    // Sem cópia válida nada é regravado e a montagem segue com a primeira;
+    // o resultado fica em mountFATReport para quem montou decidir
+    if (verifyFATOnMount) {
+        mountFATStatus = checkFATCopies(true, false, mountFATReport);
+        if (mountFATStatus == FAT16_IO_ERROR && mountFATReport.unreadableCopy >= 0) {
+            failure = "Falha ao ler a cópia " + to_string(mountFATReport.unreadableCopy) + " da FAT";
+            return FAT16_IO_ERROR;
+        }
     }
     
     // Carrega a FAT (File Allocation Table) na memória
     // Estrutura de alocação que mapeia clusters livres e ocupados (similar ao bitmap de blocos)
     if (!loadFAT()) {
-        cerr << "Erro: Falha ao carregar a FAT" << endl;
-        return false;
+        failure = "Falha ao carregar a FAT";
+        return FAT16_IO_ERROR;
     }
     
     // Carrega o diretório raiz na memória
     // Carrega a tabela de inodes/entradas de diretório para acesso rápido
-    if (!loadRootDirectory()) {
-        cerr << "Erro: Falha ao carregar o diretório raiz" << endl;
-        return false;
+    // (já carregado acima quando a FAT foi verificada na montagem)
+    if (!verifyFATOnMount && !loadRootDirectory()) {
+        failure = "Falha ao carregar o diretório raiz";
+        return FAT16_IO_ERROR;
     }
     
-    return true;
+    return FAT16_OK;
+}
+
+// Inicia o modo de gravação do trace
+// O arquivo começa com um cabeçalho fixo seguido de um registro por chamada
+bool FAT16Manager::startTrace(const string& tracePath) {
+    stopTrace();
+    traceFile.open(tracePath, ios::out | ios::binary | ios::trunc);
+    if (!traceFile.is_open()) {
+        cerr << "Erro: Não foi possível criar o arquivo de trace: " << tracePath << endl;
+        return false;
+    }
+
+    TraceFileHeader header;
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    traceFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    traceStart = chrono::steady_clock::now();
+    return traceFile.good();
+}
+
+// Encerra a gravação (os registros ficam no buffer do ofstream até aqui)
+void FAT16Manager::stopTrace() {
+    if (traceFile.is_open()) {
+        traceFile.close();
+    }
 }
 
 // Carrega o Boot Sector (primeiro setor do disco)
 // Equivalente à leitura do superbloco - contém metadados essenciais do sistema de arquivos
 bool FAT16Manager::loadBootSector() {
     // Posiciona no início do disco (setor 0, byte 0)
-    imageFile.seekg(0, ios::beg);
-    imageFile.read(reinterpret_cast<char*>(&bootSector), sizeof(BootSector));
-    
-    if (!imageFile.good()) {
+    if (!readBytes(0, reinterpret_cast<char*>(&bootSector), sizeof(BootSector))) {
         return false;
     }
     
@@ -106,324 +289,2415 @@ bool FAT16Manager::loadFAT() {
 
     // Posiciona no início da FAT e lê todo o conteúdo
     // Carrega a tabela de alocação na RAM para acesso rápido (cache)
-    imageFile.seekg(fatStartSector * bootSector.bytesPerSector, ios::beg);
-    imageFile.read(reinterpret_cast<char*>(fat.data()), fatSize);
-    
-    return imageFile.good();
+    return readBytes(uint64_t(fatStartSector) * bootSector.bytesPerSector,
+                     reinterpret_cast<char*>(fat.data()), fatSize);
 }
 
 bool FAT16Manager::loadRootDirectory() {
     uint32_t rootDirSize = bootSector.rootEntryCount * sizeof(DirectoryEntry);
     rootDirectory.resize(bootSector.rootEntryCount);
     
-    imageFile.seekg(rootDirStartSector * bootSector.bytesPerSector, ios::beg);
-    imageFile.read(reinterpret_cast<char*>(rootDirectory.data()), rootDirSize);
-    
-    return imageFile.good();
+    return readBytes(uint64_t(rootDirStartSector) * bootSector.bytesPerSector,
+                     reinterpret_cast<char*>(rootDirectory.data()), rootDirSize);
 }
 
 // Salva a FAT da memória de volta para o disco
 // Atualiza TODAS as cópias da FAT para garantir redundância e recuperação
-void FAT16Manager::saveFAT() {
+// Retorna false se alguma escrita falhou
+bool FAT16Manager::saveFAT() {
     uint32_t fatSize = bootSector.sectorsPerFAT * bootSector.bytesPerSector;
+    bool ok = true;
     
     // Atualiza todas as cópias da FAT (geralmente 2 para redundância)
     // Se uma FAT ficar corrompida, a outra pode ser usada para recuperação
     for (int i = 0; i < bootSector.numFATs; i++) {
         uint32_t fatOffset = (fatStartSector + i * bootSector.sectorsPerFAT) * bootSector.bytesPerSector;
-        imageFile.seekp(fatOffset, ios::beg);
-        imageFile.write(reinterpret_cast<const char*>(fat.data()), fatSize);
+        ok = writeChangedSectors(fatOffset, reinterpret_cast<const char*>(fat.data()), fatSize) && ok;
     }
     // Força a escrita no disco
-    imageFile.flush();
+    return flushImage() && ok;
 }
 
-void FAT16Manager::saveRootDirectory() {
+bool FAT16Manager::saveRootDirectory() {
     uint32_t rootDirSize = bootSector.rootEntryCount * sizeof(DirectoryEntry);
     
-    imageFile.seekp(rootDirStartSector * bootSector.bytesPerSector, ios::beg);
-    imageFile.write(reinterpret_cast<const char*>(rootDirectory.data()), rootDirSize);
-    imageFile.flush();
+    bool ok = writeChangedSectors(uint64_t(rootDirStartSector) * bootSector.bytesPerSector,
+                                  reinterpret_cast<const char*>(rootDirectory.data()), rootDirSize);
+    ok = flushImage() && ok;
+    
+    // O diretório inteiro foi gravado: nenhuma data de acesso fica pendente
+    if (ok) dirtyRootSectors.assign(dirtyRootSectors.size(), false);
+    return ok;
 }
 
-// Calcula o offset (deslocamento) em bytes de um cluster no disco
-uint32_t FAT16Manager::getClusterOffset(uint16_t cluster) {
-    uint32_t firstSectorOfCluster = dataStartSector + (cluster - 2) * bootSector.sectorsPerCluster;
-    
-    // Converte setor para offset em bytes
-    return firstSectorOfCluster * bootSector.bytesPerSector;
+// ============================================================================
+// DATA DE ÚLTIMO ACESSO (relatime)
+// ============================================================================
+// Uma leitura só muda lastAccessDate se a data guardada for anterior a hoje
+// ou à última modificação (a resolução do campo é de um dia, então cada
+// arquivo muda no máximo uma vez por dia). A mudança fica na cópia do
+// diretório em memória e o setor que contém a entrada é marcado como sujo;
+// flushAccessTimes grava os setores sujos agrupando os consecutivos numa
+// única escrita. Assim uma leitura nunca dispara um saveRootDirectory().
+// ============================================================================
+
+void FAT16Manager::setAccessTimeMode(bool enabled, unsigned flushSeconds) {
+    if (!enabled && imageFile.is_open()) {
+        flushAccessTimes();
+    }
+    accessTimeEnabled = enabled;
+    accessFlushSeconds = flushSeconds;
 }
 
-//Extrai e reconstrói o nome do arquivo do formato interno FAT16 para string legível
-//Ex: "FILE    TXT" -> "FILE.TXT"
-string FAT16Manager::getFileName(const DirectoryEntry& entry) {
-    string name;
+void FAT16Manager::markAccessed(DirectoryEntry& entry) {
+    if (!accessTimeEnabled) return;
 
-    for (int i = 0; i < 8 && entry.fileName[i] != ' '; i++) {
-        name += entry.fileName[i];
+    // Antes do retorno antecipado: setores sujos de leituras anteriores não
+    // podem esperar a primeira leitura do dia de outro arquivo
+    flushAccessTimesIfDue();
+
+    uint16_t today, now;
+    toFATDateTime(::time(nullptr), today, now);
+    if (entry.lastAccessDate >= today && entry.lastAccessDate >= entry.lastModifiedDate) return;
+
+    entry.lastAccessDate = today;
+    size_t sector = (&entry - rootDirectory.data()) * sizeof(DirectoryEntry) / bootSector.bytesPerSector;
+    if (dirtyRootSectors.size() != rootDirSectors) {
+        dirtyRootSectors.assign(rootDirSectors, false);
+        lastAccessFlush = chrono::steady_clock::now();
     }
-    
-    bool hasExtension = false;
-    for (int i = 0; i < 3; i++) {
-        if (entry.extension[i] != ' ') {
-            hasExtension = true;
-            break;
+    dirtyRootSectors[sector] = true;
+}
+
+// Com flushSeconds > 0, grava as datas pendentes se o intervalo venceu.
+// Além das leituras, o laço do menu e o servidor chamam periodicamente
+void FAT16Manager::flushAccessTimesIfDue() {
+    if (accessFlushSeconds == 0 || !imageFile.is_open()) return;
+    if (chrono::steady_clock::now() - lastAccessFlush < chrono::seconds(accessFlushSeconds)) return;
+    if (find(dirtyRootSectors.begin(), dirtyRootSectors.end(), true) == dirtyRootSectors.end()) {
+        lastAccessFlush = chrono::steady_clock::now();
+        return;
+    }
+    flushAccessTimes();
+}
+
+void FAT16Manager::flushAccessTimes() {
+    // Dentro de um lote o diretório em memória tem mudanças ainda não
+    // confirmadas; o commitBatch grava tudo (datas de acesso inclusive)
+    if (batchDepth > 0) return;
+
+    for (uint32_t sector = 0; sector < dirtyRootSectors.size(); ) {
+        if (!dirtyRootSectors[sector]) {
+            sector++;
+            continue;
         }
+        uint32_t runStart = sector;
+        while (sector < dirtyRootSectors.size() && dirtyRootSectors[sector]) {
+            dirtyRootSectors[sector++] = false;
+        }
+        saveRootDirectorySectors(runStart, sector - runStart);
     }
-    
-    if (hasExtension) {
-        name += '.';
-        for (int i = 0; i < 3 && entry.extension[i] != ' '; i++) {
-            name += entry.extension[i];
+    lastAccessFlush = chrono::steady_clock::now();
+}
+
+// Grava FAT e diretório raiz, ou apenas marca o lote como pendente
+bool FAT16Manager::saveMetadata() {
+    if (batchDepth > 0) {
+        batchDirty = true;
+        return true;
+    }
+    bool ok = saveFAT();
+    return saveRootDirectory() && ok;
+}
+
+void FAT16Manager::beginBatch() {
+    batchDepth++;
+}
+
+// Fecha o lote mais externo: um único saveFAT/saveRootDirectory para todas as
+// operações, e só então o espaço dos clusters liberados volta para o host.
+// Retorna false se a gravação dos metadados falhou
+bool FAT16Manager::commitBatch() {
+    if (batchDepth == 0 || --batchDepth > 0) return true;
+
+    if (batchDirty) {
+        bool ok = saveFAT();
+        ok = saveRootDirectory() && ok;
+        batchDirty = false;
+        if (!ok) {
+            // A FAT em disco pode ainda apontar para os clusters liberados:
+            // eles não podem virar buraco
+            batchFreedClusters.clear();
+            return false;
         }
     }
-    
-    return name;
+
+    // Clusters liberados e realocados dentro do mesmo lote não podem virar buraco
+    vector<uint16_t> stillFree;
+    for (uint16_t cluster : batchFreedClusters) {
+        if (fat[cluster] == FAT_FREE_CLUSTER) stillFree.push_back(cluster);
+    }
+    batchFreedClusters.clear();
+    releaseClusters(stillFree);
+    autoCompactRootDirectory();
+    return true;
 }
 
-// Define o nome de arquivo em uma entrada de diretório
-// Implementa o formato 8.3 do FAT16 (8 caracteres para o nome, 3 para a extensão)
-void FAT16Manager::setFileName(DirectoryEntry& entry, const string& name) {
-    // Inicializa com espaços (padrão FAT16)
-    memset(entry.fileName, ' ', 8);
-    memset(entry.extension, ' ', 3);
-    
-    size_t dotPos = name.find('.');
-    
-    if (dotPos == string::npos) {
-        // Arquivo sem extensão
-        for (size_t i = 0; i < min(name.length(), size_t(8)); i++) {
-            // FAT16 armazena nomes em MAIÚSCULAS (case-insensitive)
-            entry.fileName[i] = toupper(name[i]);
+// ============================================================================
+// VERIFICAÇÃO E REPARO DAS CÓPIAS DA FAT
+// ============================================================================
+// saveFAT grava o mesmo conteúdo em todas as cópias, mas loadFAT só lê a
+// primeira. Aqui todas as numFATs cópias são lidas e comparadas setor a
+// setor; cada cópia passa pela validação de cadeias (clusters fora da faixa,
+// livres/defeituosos no meio de uma cadeia, cadeias cruzadas ou em laço e
+// tamanho incompatível com o fileSize). A cópia com menos erros é a
+// referência, e apenas os setores divergentes são regravados nas demais.
+// ============================================================================
+
+// Compara dois blocos de memória; com SSE2, 64 bytes por iteração
+static bool blocksEqual(const char* a, const char* b, size_t length) {
+#if defined(__SSE2__)
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        __m128i d0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        __m128i d1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16)));
+        __m128i d2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 32)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 32)));
+        __m128i d3 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 48)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 48)));
+        __m128i all = _mm_and_si128(_mm_and_si128(d0, d1), _mm_and_si128(d2, d3));
+        if (_mm_movemask_epi8(all) != 0xFFFF) return false;
+    }
+    return memcmp(a + i, b + i, length - i) == 0;
+#else
+    return memcmp(a, b, length) == 0;
+#endif
+}
+
+// Conta os erros de cadeia dos arquivos do diretório raiz em uma cópia da FAT
+uint32_t FAT16Manager::validateFATChains(const uint16_t* table, size_t entries) const {
+    uint32_t clusterSize = bootSector.sectorsPerCluster * bootSector.bytesPerSector;
+    uint32_t dataClusters = (getTotalSectors() - dataStartSector) / bootSector.sectorsPerCluster;
+    size_t maxCluster = min<size_t>(entries, dataClusters + 2);   // Exclusivo
+
+    vector<char> used(maxCluster, 0);
+    uint32_t errors = 0;
+
+    // As duas primeiras entradas guardam o tipo de mídia e a marca de fim
+    if ((table[0] & 0xFF) != bootSector.mediaType) errors++;
+
+    for (const DirectoryEntry& entry : collectFileEntries()) {
+        uint32_t expectedClusters = (entry.fileSize + clusterSize - 1) / clusterSize;
+        uint32_t chainLength = 0;
+        uint16_t cluster = entry.firstClusterLow;
+
+        if (expectedClusters == 0) {
+            if (cluster != 0) errors++;
+            continue;
         }
-    } else {
-        // Separa nome base e extensão
-        string baseName = name.substr(0, dotPos);
-        string ext = name.substr(dotPos + 1);
-        
-        // Copia nome base (até 8 caracteres)
-        for (size_t i = 0; i < min(baseName.length(), size_t(8)); i++) {
-            entry.fileName[i] = toupper(baseName[i]);
+        while (cluster < FAT_EOF_MARKER) {
+            if (cluster < 2 || cluster >= maxCluster || used[cluster]) {
+                errors++;   // Fora da faixa, livre/reservado, cruzada ou em laço
+                break;
+            }
+            used[cluster] = 1;
+            chainLength++;
+            if (chainLength > expectedClusters) {
+                errors++;   // Cadeia maior que o arquivo
+                break;
+            }
+            cluster = table[cluster];
+        }
+        if (cluster >= FAT_EOF_MARKER && chainLength != expectedClusters) {
+            errors++;       // Cadeia termina antes do fim do arquivo
         }
+    }
+    return errors;
+}
 
-        // Copia extensão (até 3 caracteres)
-        for (size_t i = 0; i < min(ext.length(), size_t(3)); i++) {
-            entry.extension[i] = toupper(ext[i]);
+// Núcleo da verificação, sem saída no console: compara as cópias, escolhe a
+// referência e, com repair, regrava os setores divergentes. Se nenhuma cópia
+// passa na validação de cadeias, o reparo só é feito com force.
+// FAT16_OK: cópias iguais (ou reparadas) e referência sem erros de cadeia
+FAT16Status FAT16Manager::checkFATCopies(bool repair, bool force, FATCheckReport& report) {
+    TraceGuard trace(*this, TRACE_VERIFY_FAT, !repair ? "check" : force ? "force" : "repair");
+    report = FATCheckReport();
+
+    uint32_t bytesPerSector = bootSector.bytesPerSector;
+    uint32_t fatSize = bootSector.sectorsPerFAT * bytesPerSector;
+    uint32_t numFATs = bootSector.numFATs;
+    if (numFATs == 0) return FAT16_CORRUPTED;
+    report.numFATs = numFATs;
+
+    vector<vector<uint16_t>> copies(numFATs, vector<uint16_t>(fatSize / 2));
+    for (uint32_t i = 0; i < numFATs; i++) {
+        uint64_t offset = uint64_t(fatStartSector + i * bootSector.sectorsPerFAT) * bytesPerSector;
+        if (!readBytes(offset, reinterpret_cast<char*>(copies[i].data()), fatSize)) {
+            report.unreadableCopy = static_cast<int>(i);
+            return FAT16_IO_ERROR;
+        }
+    }
+
+    // Setores em que alguma cópia difere da primeira
+    vector<uint32_t>& divergent = report.divergentSectors;
+    for (uint32_t sector = 0; sector < bootSector.sectorsPerFAT; sector++) {
+        const char* first = reinterpret_cast<const char*>(copies[0].data()) + sector * bytesPerSector;
+        for (uint32_t i = 1; i < numFATs; i++) {
+            const char* other = reinterpret_cast<const char*>(copies[i].data()) + sector * bytesPerSector;
+            if (!blocksEqual(first, other, bytesPerSector)) {
+                divergent.push_back(sector);
+                break;
+            }
+        }
+    }
+
+    // Escolhe a cópia de referência pela validação das cadeias
+    uint32_t& best = report.reference;
+    vector<uint32_t>& errors = report.chainErrors;
+    errors.resize(numFATs);
+    for (uint32_t i = 0; i < numFATs; i++) {
+        errors[i] = validateFATChains(copies[i].data(), copies[i].size());
+        if (errors[i] < errors[best]) best = i;
+    }
+
+    if (divergent.empty() || !repair) {
+        trace.ok = divergent.empty() && errors[best] == 0;
+        return trace.ok ? FAT16_OK : FAT16_CORRUPTED;
+    }
+
+    // A cópia com menos erros ainda pode ser a errada: copiá-la sobre as
+    // demais apagaria a informação que permitiria um reparo manual
+    if (errors[best] > 0 && !force) {
+        report.repairRefused = true;
+        return FAT16_CORRUPTED;
+    }
+
+    // Reparo: regrava só os setores divergentes a partir da cópia de referência
+    bool written = true;
+    for (uint32_t sector : divergent) {
+        const char* source = reinterpret_cast<const char*>(copies[best].data()) + sector * bytesPerSector;
+        for (uint32_t i = 0; i < numFATs; i++) {
+            const char* target = reinterpret_cast<const char*>(copies[i].data()) + sector * bytesPerSector;
+            if (i == best || blocksEqual(source, target, bytesPerSector)) continue;
+
+            uint64_t offset = uint64_t(fatStartSector + i * bootSector.sectorsPerFAT + sector) * bytesPerSector;
+            written = writeBytes(offset, source, bytesPerSector) && written;
+            report.rewrittenSectors++;
         }
     }
+    written = flushImage() && written;
+    if (!written) return FAT16_IO_ERROR;
+
+    // A FAT em memória passa a refletir a cópia de referência
+    if (!fat.empty()) {
+        fat = copies[best];
+    }
+    report.repaired = true;
+    trace.ok = true;
+    return FAT16_OK;
 }
 
-// Formata a data armazenada em formato FAT16 para string legível "DD/MM/AAAA"
-string FAT16Manager::formatDate(uint16_t date) {
-    int day = date & 0x1F;
-    int month = (date >> 5) & 0x0F;
-    int year = ((date >> 9) & 0x7F) + 1980;
+// Versão do console: mostra o relatório da verificação (e do reparo)
+// Retorna true se as cópias estavam (ou ficaram) consistentes
+bool FAT16Manager::verifyFATCopies(bool repair, bool force) {
+    FATCheckReport report;
+    FAT16Status status = checkFATCopies(repair, force, report);
+    printFATCheckReport(status, report);
+    return status == FAT16_OK;
+}
+
+void FAT16Manager::printFATCheckReport(FAT16Status status, const FATCheckReport& report) {
+    if (report.unreadableCopy >= 0) {
+        cerr << "Erro: Falha ao ler a cópia " << report.unreadableCopy << " da FAT." << endl;
+        return;
+    }
+    if (report.numFATs == 0) {
+        cerr << "Erro: " << statusMessage(status) << "." << endl;
+        return;
+    }
+
+    const vector<uint32_t>& divergent = report.divergentSectors;
+    cout << "Verificação da FAT: " << report.numFATs << " cópia(s), " << divergent.size()
+         << " setor(es) divergente(s)." << endl;
+    for (uint32_t i = 0; i < report.numFATs; i++) {
+        cout << "  Cópia " << i << ": " << report.chainErrors[i] << " erro(s) de cadeia"
+             << (i == report.reference ? " (referência)" : "") << endl;
+    }
+    for (size_t d = 0; d < divergent.size() && d < 16; d++) {
+        cout << "  Setor " << divergent[d] << " da FAT diverge" << endl;
+    }
+    if (divergent.size() > 16) {
+        cout << "  ... e mais " << divergent.size() - 16 << " setor(es)" << endl;
+    }
+
+    if (report.chainErrors[report.reference] > 0) {
+        cerr << "Aviso: Nenhuma cópia da FAT passou na validação de cadeias." << endl;
+    }
+    if (report.repairRefused) {
+        cerr << "Erro: Reparo recusado, nenhuma cópia é confiável (use --force para regravar "
+             << "a partir da cópia " << report.reference << ")." << endl;
+    }
+    if (report.repaired) {
+        cout << "FAT reparada a partir da cópia " << report.reference << ": "
+             << report.rewrittenSectors << " setor(es) regravado(s)." << endl;
+    } else if (status == FAT16_IO_ERROR) {
+        cerr << "Erro: Falha ao regravar os setores divergentes da FAT." << endl;
+    }
+}
+
+void FAT16Manager::setVerifyFATOnMount(bool enabled) {
+    verifyFATOnMount = enabled;
+}
+
+FAT16Status FAT16Manager::mountFATCheck(FATCheckReport& report) const {
+    report = mountFATReport;
+    return mountFATStatus;
+}
+
+// Salva apenas um intervalo de setores do diretório raiz
+// (usado quando se sabe exatamente quais setores mudaram)
+bool FAT16Manager::saveRootDirectorySectors(uint32_t firstSector, uint32_t sectorCount) {
+    if (sectorCount == 0) return true;
+    uint32_t bytesPerSector = bootSector.bytesPerSector;
+    const char* data = reinterpret_cast<const char*>(rootDirectory.data());
     
-    char buffer[11];
-    snprintf(buffer, sizeof(buffer), "%02d/%02d/%04d", day, month, year);
-    return string(buffer);
+    bool ok = writeBytes(uint64_t(rootDirStartSector + firstSector) * bytesPerSector,
+                         data + uint64_t(firstSector) * bytesPerSector, sectorCount * bytesPerSector);
+    return flushImage() && ok;
 }
 
-// Formata o tempo armazenado em formato FAT16 para string legível "HH:MM:SS"
-string FAT16Manager::formatTime(uint16_t time) {
-    int second = (time & 0x1F) * 2; //5bits para segundos (multiplicado por 2)
-    int minute = (time >> 5) & 0x3F; //6bits para minutos
-    int hour = (time >> 11) & 0x1F;   //5bits para horas
+// ============================================================================
+// CAMADA DE I/O DA IMAGEM
+// ============================================================================
+// Todo acesso a setores passa por readBytes/writeBytes. No modo normal eles
+// acessam a imagem diretamente; no modo overlay (copy-on-write) a imagem base
+// é somente leitura e os setores modificados ficam em um arquivo delta esparso:
+//
+//   [DeltaHeader][bitmap de setores][... área de dados ...]
+//                                    ^ deltaDataOffset
+//
+// O setor S da imagem fica em deltaDataOffset + S * bytesPerSector, então o
+// delta só ocupa espaço no host para os setores efetivamente escritos.
+// Leituras resolvem setor a setor: delta (se o bit estiver marcado) ou base.
+// ============================================================================
 
-    char buffer[9];
-    snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d", hour, minute, second);
-    return string(buffer);
+// Ativa o modo overlay; deve ser chamado antes de initialize()
+void FAT16Manager::enableOverlay(const string& deltaPath) {
+    deltaFileName = deltaPath;
 }
 
-// Procura um cluster livre na FAT
-// Algoritmo de alocação First-Fit - encontra o primeiro bloco livre
-// Similar ao gerenciamento de memória e alocação de blocos em disco
-uint16_t FAT16Manager::findFreeCluster() {
-    // Clusters começam em 2 (0 e 1 são reservados pelo sistema)
-    for (size_t i = 2; i < fat.size(); i++) {
-        if (fat[i] == FAT_FREE_CLUSTER) {  // 0x0000 indica cluster livre
-            return i;
+bool FAT16Manager::isOverlayEnabled() const {
+    return !deltaFileName.empty();
+}
+
+uint32_t FAT16Manager::getTotalSectors() const {
+    return bootSector.totalSectors16 != 0 ? bootSector.totalSectors16 : bootSector.totalSectors32;
+}
+
+// Abre o delta existente ou cria um vazio (custo O(1): só cabeçalho + bitmap)
+bool FAT16Manager::openOverlay() {
+    uint32_t totalSectors = getTotalSectors();
+    deltaBitmap.assign((totalSectors + 7) / 8, 0);
+    
+    // Área de dados alinhada em 4 KiB para que setores do delta não compartilhem
+    // blocos do host com o cabeçalho
+    deltaDataOffset = ((sizeof(DeltaHeader) + deltaBitmap.size() + 4095) / 4096) * 4096;
+
+    deltaFile.open(deltaFileName, ios::in | ios::out | ios::binary);
+    if (deltaFile.is_open()) {
+        DeltaHeader header;
+        deltaFile.seekg(0, ios::beg);
+        deltaFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!deltaFile.good() || memcmp(header.magic, DELTA_MAGIC, sizeof(header.magic)) != 0 ||
+            header.bytesPerSector != bootSector.bytesPerSector || header.totalSectors != totalSectors) {
+            cerr << "Erro: Delta incompatível com a imagem base." << endl;
+            return false;
         }
+        deltaFile.read(reinterpret_cast<char*>(deltaBitmap.data()), deltaBitmap.size());
+        return deltaFile.good();
     }
-    //Retorna 0 se não há espaço livre (disco cheio)
-    return 0;
+
+    // Delta inexistente: cria cabeçalho e bitmap zerado
+    deltaFile.clear();
+    deltaFile.open(deltaFileName, ios::in | ios::out | ios::binary | ios::trunc);
+    if (!deltaFile.is_open()) {
+        return false;
+    }
+    return writeOverlayHeader();
 }
 
-// Busca uma entrada de arquivo no diretório raiz do FAT16 (busca dos metadados)
-// Implementa a operação de lookup (busca) em sistema de arquivos
-// Percorre linearmente o diretório (O(n) - não há índice ou hash)
-DirectoryEntry* FAT16Manager::findFileEntry(const string& fileName) {
-    // Converte para maiúsculas (FAT16 é case-insensitive)
-    string upperName = fileName;
-    transform(upperName.begin(), upperName.end(), upperName.begin(), ::toupper);
+bool FAT16Manager::writeOverlayHeader() {
+    DeltaHeader header;
+    memcpy(header.magic, DELTA_MAGIC, sizeof(header.magic));
+    header.bytesPerSector = bootSector.bytesPerSector;
+    header.totalSectors = getTotalSectors();
 
-    for (auto& entry : rootDirectory) {
-        // 0x00: fim do diretório (não há mais entradas válidas após este ponto)
-        if (entry.fileName[0] == 0x00) break;
-        
-        // 0xE5: entrada deletada (espaço pode ser reutilizado)
-        // Implementa deleção "soft" - dados ainda existem até serem sobrescritos
-        if (static_cast<uint8_t>(entry.fileName[0]) == 0xE5) continue;
-        
-        // Ignora entradas de volume label
-        if (entry.attributes & ATTR_VOLUME_ID) continue;
-        
-        // Compara nomes (case-insensitive)
-        string entryName = getFileName(entry);
-        transform(entryName.begin(), entryName.end(), entryName.begin(), ::toupper);
+    deltaFile.seekp(0, ios::beg);
+    deltaFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    deltaFile.write(reinterpret_cast<const char*>(deltaBitmap.data()), deltaBitmap.size());
+    deltaFile.flush();
+    return deltaFile.good();
+}
 
-        if (entryName == upperName) {
-            return &entry;  // Arquivo encontrado
+bool FAT16Manager::isSectorInDelta(uint64_t sector) const {
+    return (deltaBitmap[sector / 8] >> (sector % 8)) & 1;
+}
+
+bool FAT16Manager::readBytes(uint64_t offset, char* buffer, uint32_t length) {
+    return readBytesFrom(imageFile, deltaFile.is_open() ? &deltaFile : nullptr, offset, buffer, length);
+}
+
+// Leitura resolvendo o overlay sobre streams quaisquer: permite que threads
+// de trabalho usem seus próprios handles da imagem (e do delta) em paralelo,
+// pois só consulta o bitmap (somente leitura durante a operação)
+bool FAT16Manager::readBytesFrom(istream& base, istream* delta, uint64_t offset, char* buffer,
+                                 uint32_t length) const {
+    if (deltaFileName.empty() || delta == nullptr) {
+        base.seekg(offset, ios::beg);
+        base.read(buffer, length);
+        return base.good();
+    }
+
+    // Overlay: agrupa setores consecutivos com a mesma origem em uma única leitura
+    uint32_t bytesPerSector = bootSector.bytesPerSector;
+    while (length > 0) {
+        uint64_t sector = offset / bytesPerSector;
+        bool inDelta = isSectorInDelta(sector);
+        
+        uint64_t runEnd = (sector + 1) * bytesPerSector;
+        while (runEnd < offset + length && isSectorInDelta(runEnd / bytesPerSector) == inDelta) {
+            runEnd += bytesPerSector;
         }
+        uint32_t chunk = static_cast<uint32_t>(min<uint64_t>(runEnd - offset, length));
+
+        istream& source = inDelta ? *delta : base;
+        source.seekg(inDelta ? deltaDataOffset + offset : offset, ios::beg);
+        source.read(buffer, chunk);
+        if (!source.good()) return false;
+
+        offset += chunk;
+        buffer += chunk;
+        length -= chunk;
     }
-    return nullptr;  // Arquivo não encontrado
+    return true;
 }
 
-// Procura uma entrada de diretório livre no diretório raiz
-// Retorna o índice da entrada livre ou -1 se não houver espaço
-int FAT16Manager::findFreeDirectoryEntry() {
-    for (size_t i = 0; i < rootDirectory.size(); i++) {
+bool FAT16Manager::writeBytes(uint64_t offset, const char* buffer, uint32_t length) {
+    if (length == 0) return true;
+    if (deltaFileName.empty() || !deltaFile.is_open()) {
+        imageFile.seekp(offset, ios::beg);
+        imageFile.write(buffer, length);
+        return imageFile.good();
+    }
+
+    // Copy-on-write: setores parcialmente escritos que ainda não estão no delta
+    // são primeiro copiados da base, para que o restante do setor seja preservado
+    uint32_t bytesPerSector = bootSector.bytesPerSector;
+    uint64_t firstSector = offset / bytesPerSector;
+    uint64_t lastSector = (offset + length - 1) / bytesPerSector;
+    vector<char> sectorBuffer(bytesPerSector);
+
+    uint64_t edges[2] = { firstSector, lastSector };
+    for (int i = 0; i < (firstSector == lastSector ? 1 : 2); i++) {
+        uint64_t sector = edges[i];
+        bool partial = offset > sector * bytesPerSector ||
+                       offset + length < (sector + 1) * bytesPerSector;
+        if (partial && !isSectorInDelta(sector)) {
+            imageFile.seekg(sector * bytesPerSector, ios::beg);
+            imageFile.read(sectorBuffer.data(), bytesPerSector);
+            if (!imageFile.good()) {
+                // Sem o conteúdo da base o setor não pode ir para o delta
+                imageFile.clear();
+                return false;
+            }
+            deltaFile.seekp(deltaDataOffset + sector * bytesPerSector, ios::beg);
+            deltaFile.write(sectorBuffer.data(), bytesPerSector);
+        }
+    }
+
+    deltaFile.seekp(deltaDataOffset + offset, ios::beg);
+    deltaFile.write(buffer, length);
+
+    // Marca os setores no bitmap e persiste apenas os bytes do bitmap alterados
+    // (depois dos dados, para que um setor nunca seja marcado sem conteúdo)
+    bool changed = false;
+    for (uint64_t sector = firstSector; sector <= lastSector; sector++) {
+        if (!isSectorInDelta(sector)) {
+            deltaBitmap[sector / 8] |= static_cast<uint8_t>(1 << (sector % 8));
+            changed = true;
+        }
+    }
+    if (changed) {
+        size_t firstByte = firstSector / 8;
+        size_t lastByte = lastSector / 8;
+        deltaFile.seekp(sizeof(DeltaHeader) + firstByte, ios::beg);
+        deltaFile.write(reinterpret_cast<const char*>(deltaBitmap.data() + firstByte), lastByte - firstByte + 1);
+    }
+    return deltaFile.good();
+}
+
+// Grava uma região alinhada a setores (FAT, diretório raiz). No overlay só
+// vão para o delta os setores cujo conteúdo mudou: regravar a FAT inteira a
+// cada operação copiaria para o delta setores que continuam iguais à base
+bool FAT16Manager::writeChangedSectors(uint64_t offset, const char* buffer, uint32_t length) {
+    if (deltaFileName.empty() || !deltaFile.is_open()) {
+        return writeBytes(offset, buffer, length);
+    }
+
+    uint32_t bytesPerSector = bootSector.bytesPerSector;
+    vector<char> current(length);
+    if (!readBytes(offset, current.data(), length)) {
+        return writeBytes(offset, buffer, length);
+    }
+
+    // Agrupa setores alterados consecutivos em uma única escrita
+    for (uint32_t pos = 0; pos < length; ) {
+        uint32_t size = min(bytesPerSector, length - pos);
+        if (memcmp(current.data() + pos, buffer + pos, size) == 0) {
+            pos += size;
+            continue;
+        }
+        uint32_t runStart = pos;
+        while (pos < length) {
+            size = min(bytesPerSector, length - pos);
+            if (memcmp(current.data() + pos, buffer + pos, size) == 0) break;
+            pos += size;
+        }
+        if (!writeBytes(offset + runStart, buffer + runStart, pos - runStart)) return false;
+    }
+    return true;
+}
+
+bool FAT16Manager::flushImage() {
+    if (deltaFile.is_open()) {
+        return deltaFile.flush().good();
+    }
+    return imageFile.flush().good();
+}
+
+// Consolida o delta na imagem base (merge) e reinicia o overlay com um delta vazio
+bool FAT16Manager::mergeOverlay() {
+    if (!deltaFile.is_open()) {
+        cerr << "Erro: O modo overlay não está ativo." << endl;
+        return false;
+    }
+    deltaFile.flush();
+
+    // A base é aberta para escrita apenas durante a consolidação
+    fstream base(imageFileName, ios::in | ios::out | ios::binary);
+    if (!base.is_open()) {
+        cerr << "Erro: Não foi possível abrir a imagem base para escrita: " << imageFileName << endl;
+        return false;
+    }
+
+    uint32_t bytesPerSector = bootSector.bytesPerSector;
+    uint32_t totalSectors = getTotalSectors();
+    vector<char> buffer;
+    uint32_t mergedSectors = 0;
+
+    for (uint32_t sector = 0; sector < totalSectors; ) {
+        if (!isSectorInDelta(sector)) {
+            sector++;
+            continue;
+        }
+        // Copia cada sequência contígua de setores do delta em uma única escrita
+        uint32_t runEnd = sector;
+        while (runEnd < totalSectors && isSectorInDelta(runEnd)) runEnd++;
+
+        uint32_t runBytes = (runEnd - sector) * bytesPerSector;
+        buffer.resize(runBytes);
+        deltaFile.seekg(deltaDataOffset + uint64_t(sector) * bytesPerSector, ios::beg);
+        deltaFile.read(buffer.data(), runBytes);
+        base.seekp(uint64_t(sector) * bytesPerSector, ios::beg);
+        base.write(buffer.data(), runBytes);
+        if (!deltaFile.good() || !base.good()) {
+            cerr << "Erro: Falha ao consolidar o delta na imagem base." << endl;
+            return false;
+        }
+
+        mergedSectors += runEnd - sector;
+        sector = runEnd;
+    }
+    base.flush();
+    base.close();
+
+    if (!resetOverlay()) {
+        return false;
+    }
+    cout << "Overlay consolidado: " << mergedSectors << " setores gravados na imagem base." << endl;
+    return true;
+}
+
+// Descarta todas as modificações do delta e recarrega FAT e diretório da base
+bool FAT16Manager::discardOverlay() {
+    if (!deltaFile.is_open()) {
+        cerr << "Erro: O modo overlay não está ativo." << endl;
+        return false;
+    }
+    if (!resetOverlay() || !loadFAT() || !loadRootDirectory()) {
+        cerr << "Erro: Falha ao descartar o delta." << endl;
+        return false;
+    }
+    cout << "Overlay descartado: imagem restaurada ao estado da base." << endl;
+    return true;
+}
+
+// Recria o delta vazio (truncado, apenas cabeçalho + bitmap zerado)
+bool FAT16Manager::resetOverlay() {
+    deltaFile.close();
+    fill(deltaBitmap.begin(), deltaBitmap.end(), 0);
+    deltaFile.open(deltaFileName, ios::in | ios::out | ios::binary | ios::trunc);
+    if (!deltaFile.is_open()) {
+        return false;
+    }
+    // A base pode ter sido alterada pelo merge: descarta o buffer de leitura
+    imageFile.clear();
+    imageFile.seekg(0, ios::beg);
+    return writeOverlayHeader();
+}
+
+// ============================================================================
+// MODO DISCARD (devolução de espaço ao host)
+// ============================================================================
+// Imagens esparsas só ocupam no host os blocos já escritos. Sem discard, um
+// cluster escrito uma vez continua ocupando espaço mesmo depois de liberado
+// na FAT. Com discard, deleteFile faz fallocate(PUNCH_HOLE) nas sequências de
+// clusters liberados (similar ao TRIM de SSDs) e createFile, em vez de gravar
+// clusters totalmente zerados, abre um buraco no lugar (que lê como zeros).
+// ============================================================================
+
+bool FAT16Manager::setDiscardMode(bool enabled) {
+#if defined(__linux__) && defined(FALLOC_FL_PUNCH_HOLE)
+    if (discardFd >= 0) {
+        ::close(discardFd);
+        discardFd = -1;
+    }
+    discardEnabled = false;
+    if (!enabled) return true;
+
+    // Descritor próprio: fstream não expõe o fd, e fallocate precisa de um
+    // No overlay os buracos são feitos no delta, nunca na base somente leitura
+    const string& target = deltaFileName.empty() ? imageFileName : deltaFileName;
+    discardFd = ::open(target.c_str(), O_RDWR);
+    if (discardFd < 0) {
+        cerr << "Erro: Não foi possível abrir " << target << " para discard." << endl;
+        return false;
+    }
+    discardEnabled = true;
+    return true;
+#else
+    if (enabled) {
+        cerr << "Aviso: Modo discard não suportado nesta plataforma." << endl;
+    }
+    discardEnabled = false;
+    return !enabled;
+#endif
+}
+
+// Desaloca no host o intervalo [offset, offset + length) da imagem
+bool FAT16Manager::punchHole(uint64_t offset, uint64_t length) {
+#if defined(__linux__) && defined(FALLOC_FL_PUNCH_HOLE)
+    if (discardFd < 0) return false;
+    
+    // Escritas pendentes no buffer do fstream não podem cair depois do buraco
+    flushImage();
+
+    uint64_t target = deltaFileName.empty() ? offset : deltaDataOffset + offset;
+    if (fallocate(discardFd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, target, length) != 0) {
+        return false;
+    }
+
+    // No overlay, o setor deixa de estar no delta e volta a ser lido da base
+    // (o conteúdo de clusters livres é irrelevante)
+    if (!deltaFileName.empty()) {
+        uint32_t bytesPerSector = bootSector.bytesPerSector;
+        uint64_t firstSector = offset / bytesPerSector;
+        uint64_t lastSector = (offset + length - 1) / bytesPerSector;
+        for (uint64_t sector = firstSector; sector <= lastSector; sector++) {
+            deltaBitmap[sector / 8] &= static_cast<uint8_t>(~(1 << (sector % 8)));
+        }
+        deltaFile.seekp(sizeof(DeltaHeader) + firstSector / 8, ios::beg);
+        deltaFile.write(reinterpret_cast<const char*>(deltaBitmap.data() + firstSector / 8),
+                        lastSector / 8 - firstSector / 8 + 1);
+        deltaFile.flush();
+    }
+    return true;
+#else
+    (void)offset;
+    (void)length;
+    return false;
+#endif
+}
+
+// Libera no host os clusters informados, agrupando clusters consecutivos
+// em uma única chamada; retorna quantos bytes foram desalocados
+uint64_t FAT16Manager::releaseClusters(vector<uint16_t> clusters) {
+    if (!discardEnabled || clusters.empty()) return 0;
+
+    uint32_t clusterSize = bootSector.sectorsPerCluster * bootSector.bytesPerSector;
+    sort(clusters.begin(), clusters.end());
+
+    uint64_t released = 0;
+    size_t runStart = 0;
+    for (size_t i = 1; i <= clusters.size(); i++) {
+        if (i < clusters.size() && clusters[i] == clusters[i - 1] + 1) continue;
+
+        uint64_t length = uint64_t(i - runStart) * clusterSize;
+        if (punchHole(getClusterOffset(clusters[runStart]), length)) {
+            released += length;
+        }
+        runStart = i;
+    }
+    return released;
+}
+
+// ============================================================================
+// MODO DIRETO (O_DIRECT)
+// ============================================================================
+// Varreduras e importações grandes passam por todos os clusters da imagem e,
+// pelo page cache, expulsariam os dados quentes da aplicação. No modo direto
+// os clusters de dados são lidos/gravados com pread/pwrite num descritor
+// O_DIRECT; FAT e diretório raiz continuam no fstream (são pequenos e
+// reaproveitados). O_DIRECT exige buffer, offset e tamanho alinhados: os
+// buffers vêm do pool (alinhados a 4 KiB) e clusters começam e terminam em
+// fronteira de setor. Se o dispositivo exigir alinhamento maior, a primeira
+// operação falha com EINVAL e o modo é desligado, voltando ao fstream.
+// ============================================================================
+
+bool FAT16Manager::setDirectIO(bool enabled) {
+#if defined(__linux__) && defined(O_DIRECT)
+    if (directFd >= 0) {
+        ::close(directFd);
+        directFd = -1;
+    }
+    if (!enabled) return true;
+
+    if (!deltaFileName.empty()) {
+        cerr << "Erro: Modo direto não é compatível com o overlay." << endl;
+        return false;
+    }
+    directFd = ::open(imageFileName.c_str(), O_RDWR | O_DIRECT);
+    if (directFd < 0) {
+        cerr << "Erro: Não foi possível abrir " << imageFileName << " com O_DIRECT." << endl;
+        return false;
+    }
+    return true;
+#else
+    if (enabled) {
+        cerr << "Aviso: Modo direto não suportado nesta plataforma." << endl;
+    }
+    return !enabled;
+#endif
+}
+
+// Lê um cluster inteiro para um buffer do pool
+bool FAT16Manager::readCluster(uint16_t cluster, char* buffer) {
+    uint32_t clusterSize = bootSector.sectorsPerCluster * bootSector.bytesPerSector;
+#if defined(__linux__) && defined(O_DIRECT)
+    if (directFd >= 0) {
+        imageFile.flush();  // Escritas pendentes no fstream precisam chegar ao kernel
+        if (::pread(directFd, buffer, clusterSize, getClusterOffset(cluster)) == ssize_t(clusterSize)) {
+            return true;
+        }
+        cerr << "Aviso: O_DIRECT recusado pelo dispositivo; voltando ao modo normal." << endl;
+        setDirectIO(false);
+    }
+#endif
+    return readBytes(getClusterOffset(cluster), buffer, clusterSize);
+}
+
+// Grava um cluster inteiro a partir de um buffer do pool
+bool FAT16Manager::writeCluster(uint16_t cluster, const char* buffer) {
+    uint32_t clusterSize = bootSector.sectorsPerCluster * bootSector.bytesPerSector;
+#if defined(__linux__) && defined(O_DIRECT)
+    if (directFd >= 0) {
+        if (::pwrite(directFd, buffer, clusterSize, getClusterOffset(cluster)) == ssize_t(clusterSize)) {
+            return true;
+        }
+        cerr << "Aviso: O_DIRECT recusado pelo dispositivo; voltando ao modo normal." << endl;
+        setDirectIO(false);
+    }
+#endif
+    return writeBytes(getClusterOffset(cluster), buffer, clusterSize);
+}
+
+// ============================================================================
+// I/O ASSÍNCRONO DOS CLUSTERS
+// ============================================================================
+// Leituras e importações andam em janelas de queueDepth clusters: cada
+// janela empresta um buffer do pool por cluster, submete todas as
+// leituras/escritas num único lote e só então consome/preenche os buffers.
+// Assim o dispositivo recebe uma fila profunda em vez de um cluster por vez.
+// Os buffers do pool são alinhados e do tamanho do cluster, então o mesmo
+// caminho serve para o modo direto. Se o motor falhar (ex.: EINVAL do
+// O_DIRECT), o modo é desligado e a operação é refeita de forma síncrona.
+// ============================================================================
+
+bool FAT16Manager::setAsyncIO(bool enabled, unsigned queueDepth) {
+    asyncIO.close();
+    if (!enabled) return true;
+
+    if (!deltaFileName.empty()) {
+        cerr << "Erro: I/O assíncrono não é compatível com o overlay." << endl;
+        return false;
+    }
+    if (!asyncIO.open(imageFileName, directFd >= 0, queueDepth)) {
+        cerr << "Erro: Não foi possível iniciar o I/O assíncrono em " << imageFileName << endl;
+        return false;
+    }
+    return true;
+}
+
+// Janela de buffers do pool, devolvidos ao sair do escopo
+class ClusterWindow {
+public:
+    ClusterWindow(AlignedBufferPool& owner, size_t count) : pool(owner) {
+        for (size_t i = 0; i < count; i++) buffers.push_back(pool.acquire());
+    }
+    ~ClusterWindow() {
+        for (char* buffer : buffers) pool.release(buffer);
+    }
+    char* operator[](size_t i) const { return buffers[i]; }
+
+private:
+    AlignedBufferPool& pool;
+    vector<char*> buffers;
+};
+
+// Lê a cadeia inteira em lotes e entrega o conteúdo em ordem a consume.
+// Só quando o motor falha antes de entregar qualquer byte o chamador pode
+// refazer a leitura de forma síncrona (ASYNC_READ_FALLBACK); depois disso,
+// falha ou cadeia curta são erros, para o conteúdo não ser entregue duas vezes
+AsyncReadResult FAT16Manager::readChainAsync(const DirectoryEntry& entry,
+                                  const function<void(const char*, uint32_t)>& consume) {
+    uint32_t clusterSize = bootSector.sectorsPerCluster * bootSector.bytesPerSector;
+    uint32_t remaining = entry.fileSize;
+    uint16_t cluster = entry.firstClusterLow;
+    size_t windowSize = asyncIO.queueDepth();
+    ClusterWindow window(bufferPool, windowSize);
+    vector<IORequest> requests;
+    bool delivered = false;
+
+    imageFile.flush();  // Escritas pendentes no fstream precisam chegar ao kernel
+
+    while (remaining > 0) {
+        requests.clear();
+        while (requests.size() < windowSize && cluster >= 2 && cluster < FAT_EOF_MARKER &&
+               requests.size() * clusterSize < remaining) {
+            requests.push_back({ false, getClusterOffset(cluster), window[requests.size()], clusterSize });
+            cluster = fat[cluster];
+        }
+        if (requests.empty()) return ASYNC_READ_SHORT_CHAIN;
+
+        if (!asyncIO.submitAndWait(requests)) {
+            cerr << "Aviso: Falha no I/O assíncrono (" << asyncIO.backendName()
+                 << "); voltando ao modo síncrono." << endl;
+            asyncIO.close();
+            return delivered ? ASYNC_READ_IO_ERROR : ASYNC_READ_FALLBACK;
+        }
+        for (size_t i = 0; i < requests.size(); i++) {
+            uint32_t bytes = min(remaining, clusterSize);
+            consume(window[i], bytes);
+            remaining -= bytes;
+        }
+        delivered = true;
+    }
+    return ASYNC_READ_DONE;
+}
+
+// Copia fileSize bytes de source para os clusters em lotes. No modo discard,
+// clusters zerados viram buraco e ficam fora do lote. copied recebe os bytes
+// lidos de source; retorna false se alguma escrita na imagem falhou
+bool FAT16Manager::writeChainAsync(istream& source, const vector<uint16_t>& clusters, uint32_t fileSize,
+                                   uint32_t& copied) {
+    uint32_t clusterSize = bootSector.sectorsPerCluster * bootSector.bytesPerSector;
+    size_t windowSize = asyncIO.queueDepth();
+    ClusterWindow window(bufferPool, windowSize);
+    vector<IORequest> requests;
+    vector<uint16_t> requestClusters;
+    bool written = true;
+    copied = 0;
+
+    for (size_t next = 0; next < clusters.size(); ) {
+        requests.clear();
+        requestClusters.clear();
+        for (size_t slot = 0; slot < windowSize && next < clusters.size(); slot++, next++) {
+            char* buffer = window[slot];
+            source.read(buffer, min(fileSize - copied, clusterSize));
+            uint32_t bytesRead = static_cast<uint32_t>(source.gcount());
+            memset(buffer + bytesRead, 0, clusterSize - bytesRead);
+            copied += bytesRead;
+
+            uint64_t offset = getClusterOffset(clusters[next]);
+            bool zeroCluster = discardEnabled && buffer[0] == 0 &&
+                               memcmp(buffer, buffer + 1, clusterSize - 1) == 0;
+            if (zeroCluster && punchHole(offset, clusterSize)) continue;
+
+            requests.push_back({ true, offset, buffer, clusterSize });
+            requestClusters.push_back(clusters[next]);
+        }
+
+        if (asyncIO.isOpen() && asyncIO.submitAndWait(requests)) continue;
+
+        // Motor indisponível ou com erro: grava esta janela de forma síncrona
+        if (asyncIO.isOpen()) {
+            cerr << "Aviso: Falha no I/O assíncrono (" << asyncIO.backendName()
+                 << "); voltando ao modo síncrono." << endl;
+            asyncIO.close();
+        }
+        for (size_t i = 0; i < requests.size(); i++) {
+            written = writeCluster(requestClusters[i], requests[i].buffer) && written;
+        }
+    }
+    return written;
+}
+
+// ============================================================================
+// FORMATAÇÃO (mkfs)
+// ============================================================================
+// Layout criado: [Boot Sector][FAT 1]...[FAT n][Diretório raiz][Área de dados]
+// O tamanho da FAT depende do número de clusters, que depende do tamanho da
+// FAT; o cálculo é iterado até estabilizar. Só são gravados o boot sector, o
+// primeiro setor de cada FAT (entradas reservadas 0 e 1) e o rótulo do volume:
+// o resto da imagem fica como buraco no arquivo esparso e é lido como zeros.
+// ============================================================================
+
+bool FAT16Manager::formatImage(const string& imagePath, const FormatOptions& options) {
+    const uint16_t bytesPerSector = 512;
+    const uint16_t reservedSectors = 1;
+    uint8_t spc = options.sectorsPerCluster;
+
+    if (spc == 0 || (spc & (spc - 1)) != 0 || spc > 128) {
+        cerr << "Erro: Setores por cluster deve ser potência de 2 entre 1 e 128." << endl;
+        return false;
+    }
+    if (options.rootEntryCount == 0 || options.rootEntryCount % 16 != 0) {
+        cerr << "Erro: Número de entradas do diretório raiz deve ser múltiplo de 16." << endl;
+        return false;
+    }
+    if (options.numFATs == 0) {
+        cerr << "Erro: É necessária pelo menos uma FAT." << endl;
+        return false;
+    }
+
+    uint64_t totalSectors64 = options.totalBytes / bytesPerSector;
+    if (totalSectors64 > 0xFFFFFFFFull) {
+        cerr << "Erro: Imagem grande demais." << endl;
+        return false;
+    }
+    uint32_t totalSectors = static_cast<uint32_t>(totalSectors64);
+    uint32_t rootDirSectors = (options.rootEntryCount * 32 + bytesPerSector - 1) / bytesPerSector;
+
+    // Itera o tamanho da FAT até o número de clusters caber nela. A FAT só
+    // cresce: uma FAT maior deixa menos clusters, então o necessário só cai e
+    // o laço não oscila entre s e s+1 (sobra no máximo um setor de FAT)
+    uint32_t sectorsPerFAT = 1;
+    uint32_t clusters = 0;
+    bool settled = false;
+    for (int iteration = 0; iteration < 16; iteration++) {
+        uint32_t metadata = reservedSectors + options.numFATs * sectorsPerFAT + rootDirSectors;
+        if (metadata >= totalSectors) {
+            cerr << "Erro: Imagem pequena demais para esta geometria." << endl;
+            return false;
+        }
+        clusters = (totalSectors - metadata) / spc;
+        uint32_t needed = ((clusters + 2) * 2 + bytesPerSector - 1) / bytesPerSector;
+        if (needed <= sectorsPerFAT) {
+            settled = true;
+            break;
+        }
+        sectorsPerFAT = max(sectorsPerFAT, needed);
+    }
+    if (!settled) {
+        cerr << "Erro: O tamanho da FAT não convergiu para esta geometria." << endl;
+        return false;
+    }
+
+    if (clusters >= 65525 || sectorsPerFAT > 0xFFFF) {
+        cerr << "Erro: " << clusters << " clusters excedem o limite do FAT16; aumente os setores por cluster." << endl;
+        return false;
+    }
+    if (clusters < 4085) {
+        cerr << "Aviso: Apenas " << clusters << " clusters; drivers reais tratariam a imagem como FAT12." << endl;
+    }
+
+    BootSector boot;
+    memset(&boot, 0, sizeof(boot));
+    boot.jmpBoot[0] = 0xEB;
+    boot.jmpBoot[1] = 0x3C;
+    boot.jmpBoot[2] = 0x90;
+    memcpy(boot.OEMName, "FAT16MGR", 8);
+    boot.bytesPerSector = bytesPerSector;
+    boot.sectorsPerCluster = spc;
+    boot.reservedSectors = reservedSectors;
+    boot.numFATs = options.numFATs;
+    boot.rootEntryCount = options.rootEntryCount;
+    boot.totalSectors16 = totalSectors < 0x10000 ? static_cast<uint16_t>(totalSectors) : 0;
+    boot.totalSectors32 = totalSectors < 0x10000 ? 0 : totalSectors;
+    boot.mediaType = 0xF8;                 // Disco fixo
+    boot.sectorsPerFAT = static_cast<uint16_t>(sectorsPerFAT);
+    boot.sectorsPerTrack = 63;
+    boot.numHeads = 255;
+    boot.driveNumber = 0x80;
+    boot.bootSignature = 0x29;
+    boot.volumeID = static_cast<uint32_t>(::time(nullptr));
+    memset(boot.volumeLabel, ' ', sizeof(boot.volumeLabel));
+    memcpy(boot.volumeLabel, options.volumeLabel.empty() ? "NO NAME" : options.volumeLabel.c_str(),
+           min<size_t>(options.volumeLabel.empty() ? 7 : options.volumeLabel.size(), sizeof(boot.volumeLabel)));
+    memcpy(boot.fsType, "FAT16   ", 8);
+
+    vector<char> sector(bytesPerSector, 0);
+    memcpy(sector.data(), &boot, sizeof(boot));
+    sector[510] = 0x55;                     // Assinatura do setor de boot
+    sector[511] = static_cast<char>(0xAA);
+
+    ofstream image(imagePath, ios::binary | ios::trunc);
+    if (!image.is_open()) {
+        cerr << "Erro: Não foi possível criar a imagem: " << imagePath << endl;
+        return false;
+    }
+    image.write(sector.data(), bytesPerSector);
+
+    // Entradas reservadas da FAT: tipo de mídia e marca de fim de cadeia
+    vector<char> fatSector(bytesPerSector, 0);
+    uint16_t reserved[2] = { static_cast<uint16_t>(0xFF00 | boot.mediaType), 0xFFFF };
+    memcpy(fatSector.data(), reserved, sizeof(reserved));
+    for (uint32_t i = 0; i < options.numFATs; i++) {
+        image.seekp(uint64_t(reservedSectors + i * sectorsPerFAT) * bytesPerSector, ios::beg);
+        image.write(fatSector.data(), bytesPerSector);
+    }
+
+    // Rótulo do volume como primeira entrada do diretório raiz
+    if (!options.volumeLabel.empty()) {
+        DirectoryEntry label;
+        memset(&label, 0, sizeof(label));
+        memset(label.fileName, ' ', 8);
+        memset(label.extension, ' ', 3);
+        memcpy(label.fileName, options.volumeLabel.c_str(), min<size_t>(options.volumeLabel.size(), 11));
+        label.attributes = ATTR_VOLUME_ID;
+        image.seekp(uint64_t(reservedSectors + options.numFATs * sectorsPerFAT) * bytesPerSector, ios::beg);
+        image.write(reinterpret_cast<const char*>(&label), sizeof(label));
+    }
+    image.close();
+    if (!image.good()) {
+        cerr << "Erro: Falha ao gravar a imagem: " << imagePath << endl;
+        return false;
+    }
+
+    // Estende até o tamanho final sem alocar blocos (arquivo esparso)
+#ifdef _WIN32
+    fstream extend(imagePath, ios::in | ios::out | ios::binary);
+    extend.seekp(uint64_t(totalSectors) * bytesPerSector - 1, ios::beg);
+    extend.put('\0');
+#else
+    if (truncate(imagePath.c_str(), off_t(totalSectors) * bytesPerSector) != 0) {
+        cerr << "Erro: Não foi possível definir o tamanho da imagem." << endl;
+        return false;
+    }
+#endif
+
+    cout << "Imagem formatada: " << totalSectors << " setores, " << int(spc) << " setor(es)/cluster ("
+         << spc * bytesPerSector << " bytes), " << clusters << " clusters, " << int(options.numFATs) << " FAT(s) de "
+         << sectorsPerFAT << " setores, " << options.rootEntryCount << " entradas no diretório raiz." << endl;
+    return true;
+}
+
+// Calcula o offset (deslocamento) em bytes de um cluster no disco
+uint32_t FAT16Manager::getClusterOffset(uint16_t cluster) const {
+    uint32_t firstSectorOfCluster = dataStartSector + (cluster - 2) * bootSector.sectorsPerCluster;
+    
+    // Converte setor para offset em bytes
+    return firstSectorOfCluster * bootSector.bytesPerSector;
+}
+
+//Extrai e reconstrói o nome do arquivo do formato interno FAT16 para string legível
+//Ex: "FILE    TXT" -> "FILE.TXT"
+string FAT16Manager::getFileName(const DirectoryEntry& entry) {
+    string name;
+
+    for (int i = 0; i < 8 && entry.fileName[i] != ' '; i++) {
+        name += entry.fileName[i];
+    }
+    
+    bool hasExtension = false;
+    for (int i = 0; i < 3; i++) {
+        if (entry.extension[i] != ' ') {
+            hasExtension = true;
+            break;
+        }
+    }
+    
+    if (hasExtension) {
+        name += '.';
+        for (int i = 0; i < 3 && entry.extension[i] != ' '; i++) {
+            name += entry.extension[i];
+        }
+    }
+    
+    return name;
+}
+
+// Define o nome de arquivo em uma entrada de diretório
+// Implementa o formato 8.3 do FAT16 (8 caracteres para o nome, 3 para a extensão)
+void FAT16Manager::setFileName(DirectoryEntry& entry, const string& name) {
+    // Inicializa com espaços (padrão FAT16)
+    memset(entry.fileName, ' ', 8);
+    memset(entry.extension, ' ', 3);
+    
+    size_t dotPos = name.find('.');
+    
+    if (dotPos == string::npos) {
+        // Arquivo sem extensão
+        for (size_t i = 0; i < min(name.length(), size_t(8)); i++) {
+            // FAT16 armazena nomes em MAIÚSCULAS (case-insensitive)
+            entry.fileName[i] = toupper(name[i]);
+        }
+    } else {
+        // Separa nome base e extensão
+        string baseName = name.substr(0, dotPos);
+        string ext = name.substr(dotPos + 1);
+        
+        // Copia nome base (até 8 caracteres)
+        for (size_t i = 0; i < min(baseName.length(), size_t(8)); i++) {
+            entry.fileName[i] = toupper(baseName[i]);
+        }
+
+        // Copia extensão (até 3 caracteres)
+        for (size_t i = 0; i < min(ext.length(), size_t(3)); i++) {
+            entry.extension[i] = toupper(ext[i]);
+        }
+    }
+}
+
+// Formata a data armazenada em formato FAT16 para string legível "DD/MM/AAAA"
+string FAT16Manager::formatDate(uint16_t date) {
+    int day = date & 0x1F;
+    int month = (date >> 5) & 0x0F;
+    int year = ((date >> 9) & 0x7F) + 1980;
+    
+    char buffer[11];
+    snprintf(buffer, sizeof(buffer), "%02d/%02d/%04d", day, month, year);
+    return string(buffer);
+}
+
+// Formata o tempo armazenado em formato FAT16 para string legível "HH:MM:SS"
+string FAT16Manager::formatTime(uint16_t time) {
+    int second = (time & 0x1F) * 2; //5bits para segundos (multiplicado por 2)
+    int minute = (time >> 5) & 0x3F; //6bits para minutos
+    int hour = (time >> 11) & 0x1F;   //5bits para horas
+
+    char buffer[9];
+    snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d", hour, minute, second);
+    return string(buffer);
+}
+
+// Procura um cluster livre na FAT
+// Algoritmo de alocação First-Fit - encontra o primeiro bloco livre
+// Similar ao gerenciamento de memória e alocação de blocos em disco
+uint16_t FAT16Manager::findFreeCluster() {
+    // Clusters começam em 2 (0 e 1 são reservados pelo sistema)
+    for (size_t i = 2; i < fat.size(); i++) {
+        if (fat[i] == FAT_FREE_CLUSTER) {  // 0x0000 indica cluster livre
+            return i;
+        }
+    }
+    //Retorna 0 se não há espaço livre (disco cheio)
+    return 0;
+}
+
+// Busca uma entrada de arquivo no diretório raiz do FAT16 (busca dos metadados)
+// Implementa a operação de lookup (busca) em sistema de arquivos
+// Percorre linearmente o diretório (O(n) - não há índice ou hash)
+DirectoryEntry* FAT16Manager::findFileEntry(const string& fileName) {
+    // Converte para maiúsculas (FAT16 é case-insensitive)
+    string upperName = fileName;
+    transform(upperName.begin(), upperName.end(), upperName.begin(), ::toupper);
+
+    for (auto& entry : rootDirectory) {
+        // 0x00: fim do diretório (não há mais entradas válidas após este ponto)
+        if (entry.fileName[0] == 0x00) break;
+        
+        // 0xE5: entrada deletada (espaço pode ser reutilizado)
+        // Implementa deleção "soft" - dados ainda existem até serem sobrescritos
+        if (static_cast<uint8_t>(entry.fileName[0]) == 0xE5) continue;
+        
+        // Ignora entradas de volume label
+        if (entry.attributes & ATTR_VOLUME_ID) continue;
+        
+        // Compara nomes (case-insensitive)
+        string entryName = getFileName(entry);
+        transform(entryName.begin(), entryName.end(), entryName.begin(), ::toupper);
+
+        if (entryName == upperName) {
+            return &entry;  // Arquivo encontrado
+        }
+    }
+    return nullptr;  // Arquivo não encontrado
+}
+
+// Procura uma entrada de diretório livre no diretório raiz
+// Retorna o índice da entrada livre ou -1 se não houver espaço
+int FAT16Manager::findFreeDirectoryEntry() {
+    for (size_t i = 0; i < rootDirectory.size(); i++) {
         if (rootDirectory[i].fileName[0] == 0x00 || static_cast<uint8_t>(rootDirectory[i].fileName[0]) == 0xE5) {
             return i;
         }
     }
-    return -1;
+    return -1;
+}
+
+// ============================================================================
+// COMPACTAÇÃO DO DIRETÓRIO RAIZ
+// ============================================================================
+// deleteFile só marca a entrada com 0xE5 e o marcador de fim (0x00) nunca
+// volta, então as buscas lineares passam por todas as entradas apagadas.
+// A compactação move as entradas válidas para o início da tabela (mantendo a
+// ordem), zera o espaço liberado (o primeiro zero passa a ser o novo fim) e
+// grava somente os setores do diretório que realmente mudaram.
+// Os ponteiros DirectoryEntry* obtidos antes da compactação ficam inválidos.
+// ============================================================================
+
+// Retorna o número de entradas apagadas removidas
+int FAT16Manager::compactRootDirectory() {
+    TraceGuard trace(*this, TRACE_COMPACT_ROOT);
+    trace.ok = true;
+
+    vector<DirectoryEntry> before = rootDirectory;
+    size_t writeIndex = 0;
+    size_t scanEnd = 0;
+    int removed = 0;
+
+    for (scanEnd = 0; scanEnd < rootDirectory.size(); scanEnd++) {
+        const DirectoryEntry& entry = rootDirectory[scanEnd];
+        if (entry.fileName[0] == 0x00) break;
+        if (static_cast<uint8_t>(entry.fileName[0]) == 0xE5) {
+            removed++;
+            continue;
+        }
+        if (writeIndex != scanEnd) {
+            rootDirectory[writeIndex] = entry;
+        }
+        writeIndex++;
+    }
+    if (removed == 0) return 0;
+
+    // Novo fim do diretório logo após a última entrada válida
+    for (size_t i = writeIndex; i < scanEnd; i++) {
+        memset(&rootDirectory[i], 0, sizeof(DirectoryEntry));
+    }
+
+    // Persiste só as sequências de setores alterados
+    uint32_t entriesPerSector = bootSector.bytesPerSector / sizeof(DirectoryEntry);
+    uint32_t lastSector = (scanEnd - 1) / entriesPerSector;
+    uint32_t runStart = 0;
+    bool inRun = false;
+    for (uint32_t sector = writeIndex / entriesPerSector; sector <= lastSector + 1; sector++) {
+        bool changed = sector <= lastSector &&
+                       memcmp(&before[sector * entriesPerSector], &rootDirectory[sector * entriesPerSector],
+                              bootSector.bytesPerSector) != 0;
+        if (changed && !inRun) {
+            runStart = sector;
+            inRun = true;
+        } else if (!changed && inRun) {
+            saveRootDirectorySectors(runStart, sector - runStart);
+            inRun = false;
+        }
+    }
+    return removed;
+}
+
+// Ativa a compactação automática após deleteFile quando as entradas apagadas
+// passam de tombstonePercent% das entradas percorridas até o marcador de fim
+void FAT16Manager::setAutoCompact(unsigned tombstonePercent) {
+    autoCompactPercent = min(tombstonePercent, 100u);
+}
+
+void FAT16Manager::autoCompactRootDirectory() {
+    if (autoCompactPercent == 0) return;
+
+    size_t scanned = 0;
+    size_t tombstones = 0;
+    for (; scanned < rootDirectory.size(); scanned++) {
+        if (rootDirectory[scanned].fileName[0] == 0x00) break;
+        if (static_cast<uint8_t>(rootDirectory[scanned].fileName[0]) == 0xE5) tombstones++;
+    }
+    if (tombstones > 0 && tombstones * 100 >= scanned * autoCompactPercent) {
+        compactRootDirectory();
+    }
+}
+
+// ============================================================================
+// SAÍDA ESTRUTURADA (JSON / CSV)
+// ============================================================================
+// Todas as linhas são montadas num único buffer e escritas com um cout.write
+// no final: sem endl (flush) por linha. Cada registro é uma lista de campos
+// chave/valor; no CSV as chaves do primeiro registro viram o cabeçalho.
+// ============================================================================
+
+class RecordWriter {
+public:
+    RecordWriter(OutputFormat outputFormat) : format(outputFormat), records(0) {}
+
+    void field(const char* key, const string& value) { add(key, value, false); }
+    void field(const char* key, uint64_t value) { add(key, to_string(value), true); }
+
+    void endRecord() {
+        if (format == OUTPUT_JSON) {
+            buffer += records > 0 ? ",\n  {" : "  {";
+            for (size_t i = 0; i < keys.size(); i++) {
+                buffer += (i > 0 ? ", \"" : "\"") + keys[i] + "\": ";
+                buffer += numeric[i] ? values[i] : jsonString(values[i]);
+            }
+            buffer += "}";
+        } else {
+            if (records == 0) buffer += joinCSV(keys);
+            buffer += joinCSV(values);
+        }
+        records++;
+        keys.clear();
+        values.clear();
+        numeric.clear();
+    }
+
+    // Escreve tudo de uma vez; no JSON, asArray envolve os registros em [ ]
+    void flush(bool asArray) {
+        if (format == OUTPUT_JSON) {
+            if (asArray) {
+                buffer = "[\n" + buffer + (records > 0 ? "\n]\n" : "]\n");
+            } else {
+                buffer = buffer.substr(buffer.find('{')) + "\n";
+            }
+        }
+        cout.write(buffer.data(), buffer.size());
+        cout.flush();
+    }
+
+    // Data/hora FAT em ISO 8601 (sem a hora quando time < 0; vazio se não definida)
+    static string isoDateTime(uint16_t date, int time = -1) {
+        if (date == 0) return string();
+        char text[20];
+        int length = snprintf(text, sizeof(text), "%04d-%02d-%02d", ((date >> 9) & 0x7F) + 1980,
+                              (date >> 5) & 0x0F, date & 0x1F);
+        if (time >= 0) {
+            snprintf(text + length, sizeof(text) - length, "T%02d:%02d:%02d",
+                     (time >> 11) & 0x1F, (time >> 5) & 0x3F, (time & 0x1F) * 2);
+        }
+        return text;
+    }
+
+private:
+    void add(const char* key, const string& value, bool isNumber) {
+        keys.push_back(key);
+        values.push_back(value);
+        numeric.push_back(isNumber);
+    }
+
+    static string jsonString(const string& value) {
+        string out = "\"";
+        for (unsigned char c : value) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (c < 0x20) {
+                char escaped[7];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            } else {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    // Campos com vírgula, aspas ou quebra de linha vão entre aspas (RFC 4180)
+    static string joinCSV(const vector<string>& fields) {
+        string line;
+        for (size_t i = 0; i < fields.size(); i++) {
+            if (i > 0) line += ',';
+            if (fields[i].find_first_of(",\"\r\n") == string::npos) {
+                line += fields[i];
+                continue;
+            }
+            line += '"';
+            for (char c : fields[i]) {
+                if (c == '"') line += '"';
+                line += c;
+            }
+            line += '"';
+        }
+        return line + "\r\n";
+    }
+
+    OutputFormat format;
+    size_t records;
+    string buffer;
+    vector<string> keys;
+    vector<string> values;
+    vector<bool> numeric;
+};
+
+// Atributos como letras (R = somente leitura, H = oculto, S = sistema, A = arquivo)
+static string attributeLetters(uint8_t attributes) {
+    string letters;
+    if (attributes & ATTR_READ_ONLY) letters += 'R';
+    if (attributes & ATTR_HIDDEN) letters += 'H';
+    if (attributes & ATTR_SYSTEM) letters += 'S';
+    if (attributes & ATTR_ARCHIVE) letters += 'A';
+    return letters;
+}
+
+void FAT16Manager::setOutputFormat(OutputFormat format) {
+    outputFormat = format;
+}
+
+// Conta os clusters da cadeia e quantos trechos fisicamente contíguos ela tem
+void FAT16Manager::chainStats(const DirectoryEntry& entry, uint32_t& clusters, uint32_t& fragments) const {
+    clusters = 0;
+    fragments = 0;
+    uint16_t cluster = entry.firstClusterLow;
+    uint16_t previous = 0;
+    // O limite de passos protege contra cadeias em laço
+    while (cluster >= 2 && cluster < FAT_EOF_MARKER && cluster < fat.size() && clusters < fat.size()) {
+        if (cluster != previous + 1) fragments++;
+        clusters++;
+        previous = cluster;
+        cluster = fat[cluster];
+    }
+}
+
+// Lista os arquivos no diretório raiz do FAT16
+void FAT16Manager::listFiles() {
+    TraceGuard trace(*this, TRACE_LIST_FILES);
+    trace.ok = true;
+    
+    if (outputFormat != OUTPUT_TEXT) {
+        RecordWriter writer(outputFormat);
+        uint32_t clusters, fragments;
+        for (const DirectoryEntry& entry : collectFileEntries()) {
+            chainStats(entry, clusters, fragments);
+            writer.field("name", getFileName(entry));
+            writer.field("size", entry.fileSize);
+            writer.field("clusters", clusters);
+            writer.field("fragments", fragments);
+            writer.field("attributes", attributeLetters(entry.attributes));
+            writer.field("modified", RecordWriter::isoDateTime(entry.lastModifiedDate, entry.lastModifiedTime));
+            writer.endRecord();
+        }
+        writer.flush(true);
+        return;
+    }
+    
+    // Monta a tabela inteira antes de escrever (um único flush no final)
+    ostringstream out;
+    out << "\n========== CONTEÚDO DO DISCO ==========\n";
+    out << left << setw(20) << "Nome do Arquivo" 
+        << right << setw(15) << "Tamanho (bytes)" << "\n";
+    out << string(35, '-') << "\n";
+
+    int fileCount = 0;
+    for (const DirectoryEntry& entry : collectFileEntries()) {
+        string fileName = getFileName(entry);
+        out << left << setw(20) << fileName 
+            << right << setw(15) << entry.fileSize << "\n";
+        fileCount++;
+    }
+    
+    if (fileCount == 0) {
+        out << "Nenhum arquivo encontrado no diretório raiz.\n";
+    }
+    out << "\nTotal de arquivos: " << fileCount << "\n";
+    out << "========================================\n\n";
+    cout << out.str() << flush;
+}
+
+// Exibe o conteúdo de um arquivo
+// Implementa a operação de leitura sequencial de arquivo
+// Segue a cadeia de clusters na FAT
+void FAT16Manager::showFileContent(const string& fileName) {
+    TraceGuard trace(*this, TRACE_SHOW_CONTENT, fileName);
+    DirectoryEntry* entry = findFileEntry(fileName);
+    
+    if (!entry) {
+        cerr << "Erro: Arquivo '" << fileName << "' não encontrado." << endl;
+        return;
+    }
+    trace.ok = true;
+    markAccessed(*entry);
+    
+    if (entry->fileSize == 0) {
+        cout << "\nArquivo vazio." << endl;
+        return;
+    }
+
+    cout << "\n========== CONTEÚDO DO ARQUIVO: " << fileName << " ==========\n";
+
+    // Obtém o primeiro cluster do arquivo (início da cadeia)
+    uint16_t cluster = entry->firstClusterLow;
+    uint32_t remainingBytes = entry->fileSize;
+    uint32_t clusterSize = bootSector.sectorsPerCluster * bootSector.bytesPerSector;
+
+    // Modo assíncrono: a cadeia é lida em lotes de queueDepth clusters
+    AsyncReadResult async = ASYNC_READ_FALLBACK;
+    if (asyncIO.isOpen()) {
+        async = readChainAsync(*entry, [](const char* data, uint32_t bytes) {
+            cout.write(data, bytes);
+        });
+    }
+    if (async != ASYNC_READ_FALLBACK) {
+        if (async == ASYNC_READ_SHORT_CHAIN) {
+            cerr << "\nErro: A cadeia de clusters é mais curta que o tamanho do arquivo (arquivo corrompido)." << endl;
+        } else if (async == ASYNC_READ_IO_ERROR) {
+            cerr << "\nErro: Falha de I/O ao ler o arquivo." << endl;
+        }
+        cout << "\n========================================\n" << endl;
+        return;
+    }
+
+    // Buffer de cluster emprestado do pool (sem alocação por chamada)
+    PooledBuffer buffer(bufferPool);
+
+    // Percorre a linked list de clusters na FAT
+    // Cada cluster aponta para o próximo até encontrar EOF (0xFFF8-0xFFFF)
+    while (cluster >= 2 && cluster < FAT_EOF_MARKER && remainingBytes > 0) {
+        uint32_t bytesToRead = min(remainingBytes, clusterSize);
+
+        // Lê o conteúdo do cluster (inteiro, como exige o modo direto)
+        readCluster(cluster, buffer.data());
+        
+        // Exibe o conteúdo
+        cout.write(buffer.data(), bytesToRead);
+        
+        remainingBytes -= bytesToRead;
+        
+        // Busca o próximo cluster na cadeia (follow the pointer)
+        cluster = fat[cluster];
+    }
+    if (remainingBytes > 0) {
+        cerr << "\nErro: A cadeia de clusters é mais curta que o tamanho do arquivo (arquivo corrompido)." << endl;
+    }
+
+    cout << "\n========================================\n" << endl;
+}
+
+// Exibe os atributos e metadados de um arquivo
+void FAT16Manager::showFileAttributes(const string& fileName) {
+    TraceGuard trace(*this, TRACE_SHOW_ATTRIBUTES, fileName);
+    DirectoryEntry* entry = findFileEntry(fileName);
+    
+    if (!entry) {
+        cerr << "Erro: Arquivo '" << fileName << "' não encontrado." << endl;
+        return;
+    }
+    trace.ok = true;
+
+    uint32_t clusters, fragments;
+    chainStats(*entry, clusters, fragments);
+
+    if (outputFormat != OUTPUT_TEXT) {
+        RecordWriter writer(outputFormat);
+        writer.field("name", getFileName(*entry));
+        writer.field("size", entry->fileSize);
+        writer.field("clusters", clusters);
+        writer.field("fragments", fragments);
+        writer.field("attributes", attributeLetters(entry->attributes));
+        writer.field("created", RecordWriter::isoDateTime(entry->creationDate, entry->creationTime));
+        writer.field("modified", RecordWriter::isoDateTime(entry->lastModifiedDate, entry->lastModifiedTime));
+        writer.field("accessed", RecordWriter::isoDateTime(entry->lastAccessDate));
+        writer.field("firstCluster", entry->firstClusterLow);
+        writer.endRecord();
+        writer.flush(false);
+        return;
+    }
+
+    cout << "\n========== ATRIBUTOS DO ARQUIVO: " << fileName << " ==========\n";
+    cout << "Nome completo: " << getFileName(*entry) << endl;
+    cout << "Tamanho: " << entry->fileSize << " bytes" << endl;
+    cout << "\nDatas e Horários:" << endl;
+    cout << "  Criação:           " << formatDate(entry->creationDate) << " " << formatTime(entry->creationTime) << endl;
+    cout << "  Última modificação: " << formatDate(entry->lastModifiedDate) << " " << formatTime(entry->lastModifiedTime) << endl;
+    cout << "  Último acesso:      " << formatDate(entry->lastAccessDate) << endl;
+
+    cout << "\nAtributos:" << endl;
+    cout << "  Somente leitura: " << ((entry->attributes & ATTR_READ_ONLY) ? "SIM" : "NÃO") << endl;
+    cout << "  Oculto:          " << ((entry->attributes & ATTR_HIDDEN) ? "SIM" : "NÃO") << endl;
+    cout << "  Arquivo sistema: " << ((entry->attributes & ATTR_SYSTEM) ? "SIM" : "NÃO") << endl;
+    cout << "  Arquivo:         " << ((entry->attributes & ATTR_ARCHIVE) ? "SIM" : "NÃO") << endl;
+
+    cout << "\nInformações técnicas:" << endl;
+    cout << "  Primeiro cluster: " << entry->firstClusterLow << endl;
+    cout << "  Clusters: " << clusters << " (" << fragments << " fragmento(s))" << endl;
+    cout << "========================================\n" << endl;
+}
+
+// Lê o conteúdo completo de um arquivo para a memória, sem imprimir nada
+// Segue a cadeia de clusters como showFileContent
+bool FAT16Manager::readFile(const string& fileName, vector<char>& data) {
+    TraceGuard trace(*this, TRACE_READ_FILE, fileName);
+    DirectoryEntry* entry = findFileEntry(fileName);
+    if (!entry) return false;
+
+    data.resize(entry->fileSize);
+    trace.ok = (readFileCore(*entry, data.data()) == FAT16_OK);
+    return trace.ok;
+}
+
+// Lê fileSize bytes da cadeia do arquivo para buffer (que comporta o arquivo inteiro)
+FAT16Status FAT16Manager::readFileCore(DirectoryEntry& entry, char* buffer) {
+    uint32_t clusterSize = bootSector.sectorsPerCluster * bootSector.bytesPerSector;
+    uint32_t position = 0;
+
+    if (asyncIO.isOpen()) {
+        AsyncReadResult async = readChainAsync(entry, [&](const char* chunk, uint32_t bytes) {
+            memcpy(buffer + position, chunk, bytes);
+            position += bytes;
+        });
+        if (async == ASYNC_READ_SHORT_CHAIN) return FAT16_CORRUPTED;
+        if (async == ASYNC_READ_IO_ERROR) return FAT16_IO_ERROR;
+        if (async == ASYNC_READ_DONE) {
+            markAccessed(entry);
+            return FAT16_OK;
+        }
+    }
+
+    uint16_t cluster = entry.firstClusterLow;
+    while (cluster >= 2 && cluster < FAT_EOF_MARKER && position < entry.fileSize) {
+        uint32_t bytesToRead = min(entry.fileSize - position, clusterSize);
+        if (directFd >= 0) {
+            // O destino não é alinhado: lê o cluster num buffer do pool e copia
+            PooledBuffer pooled(bufferPool);
+            if (!readCluster(cluster, pooled.data())) return FAT16_IO_ERROR;
+            memcpy(buffer + position, pooled.data(), bytesToRead);
+        } else if (!readBytes(getClusterOffset(cluster), buffer + position, bytesToRead)) {
+            return FAT16_IO_ERROR;
+        }
+        position += bytesToRead;
+        cluster = fat[cluster];
+    }
+
+    // Cadeia mais curta que o tamanho declarado: arquivo corrompido
+    if (position != entry.fileSize) return FAT16_CORRUPTED;
+    markAccessed(entry);
+    return FAT16_OK;
+}
+
+// Retorna uma cópia da entrada de diretório do arquivo
+bool FAT16Manager::getFileInfo(const string& fileName, DirectoryEntry& info) {
+    TraceGuard trace(*this, TRACE_GET_FILE_INFO, fileName);
+    DirectoryEntry* entry = findFileEntry(fileName);
+    if (!entry) return false;
+
+    info = *entry;
+    trace.ok = true;
+    return true;
+}
+
+// Retorna as entradas de arquivos válidos do diretório raiz (mesmo filtro de listFiles)
+vector<DirectoryEntry> FAT16Manager::getFileEntries() {
+    TraceGuard trace(*this, TRACE_GET_FILE_ENTRIES);
+    trace.ok = true;
+    return collectFileEntries();
+}
+
+vector<DirectoryEntry> FAT16Manager::collectFileEntries() const {
+    vector<DirectoryEntry> entries;
+    for (const auto& entry : rootDirectory) {
+        if (entry.fileName[0] == 0x00) break;
+        if (static_cast<uint8_t>(entry.fileName[0]) == 0xE5) continue;
+        if (entry.attributes & ATTR_VOLUME_ID) continue;
+        if (entry.attributes & ATTR_DIRECTORY) continue;
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+// ============================================================================
+// LEITURA PARALELA DE ARQUIVOS (busca de conteúdo e checksums)
+// ============================================================================
+// Cada thread abre seus próprios handles da imagem (e do delta, no overlay) e
+// pega o próximo arquivo de uma fila compartilhada (índice atômico), então
+// arquivos grandes não seguram os demais. O conteúdo de cada arquivo é lido
+// em extents: clusters fisicamente consecutivos da cadeia viram uma única
+// leitura de até 1 MiB.
+// ============================================================================
+
+void FAT16Manager::forEachFileParallel(size_t count, unsigned threads,
+                                       const function<void(size_t, istream&, istream*)>& work) {
+    if (count == 0) return;
+
+    // Escritas pendentes no buffer do fstream precisam ser visíveis aos outros handles
+    flushImage();
+
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(min<size_t>(threads, count));
+    atomic<size_t> nextFile(0);
+
+    auto worker = [&]() {
+        ifstream base(imageFileName, ios::binary);
+        ifstream delta;
+        if (!deltaFileName.empty()) {
+            delta.open(deltaFileName, ios::binary);
+        }
+        istream* deltaStream = delta.is_open() ? &delta : nullptr;
+
+        for (size_t i = nextFile++; i < count; i = nextFile++) {
+            work(i, base, deltaStream);
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();   // A thread atual também trabalha
+    for (thread& t : pool) {
+        t.join();
+    }
+}
+
+// Lê o arquivo extent por extent em buffer[headroom...] e chama
+// consume(offset no arquivo, bytes lidos) para cada um. Os primeiros
+// headroom bytes do buffer ficam livres para uso do chamador.
+// Retorna false se a leitura falhar ou a cadeia acabar antes do tamanho declarado.
+bool FAT16Manager::readFileExtents(const DirectoryEntry& entry, istream& base, istream* delta,
+                                   vector<char>& buffer, uint32_t headroom,
+                                   const function<void(uint32_t, uint32_t)>& consume) const {
+    uint32_t clusterSize = bootSector.sectorsPerCluster * bootSector.bytesPerSector;
+    uint32_t maxRunClusters = max(1u, (1u << 20) / clusterSize);
+    buffer.resize(headroom + maxRunClusters * clusterSize);
+
+    uint32_t filePosition = 0;
+    uint32_t remainingBytes = entry.fileSize;
+    uint16_t cluster = entry.firstClusterLow;
+
+    while (cluster >= 2 && cluster < FAT_EOF_MARKER && remainingBytes > 0) {
+        // Agrupa clusters fisicamente consecutivos da cadeia
+        uint16_t runStart = cluster;
+        uint32_t runClusters = 1;
+        while (runClusters < maxRunClusters && runClusters * clusterSize < remainingBytes &&
+               fat[cluster] == cluster + 1) {
+            cluster = fat[cluster];
+            runClusters++;
+        }
+
+        uint32_t bytes = min(remainingBytes, runClusters * clusterSize);
+        if (!readBytesFrom(base, delta, getClusterOffset(runStart), buffer.data() + headroom, bytes)) {
+            return false;
+        }
+        consume(filePosition, bytes);
+
+        filePosition += bytes;
+        remainingBytes -= bytes;
+        cluster = fat[cluster];
+    }
+    return remainingBytes == 0;
+}
+
+vector<SearchResult> FAT16Manager::searchContent(const string& pattern, unsigned threads) {
+    TraceGuard trace(*this, TRACE_SEARCH_CONTENT, pattern);
+    trace.ok = true;
+
+    vector<SearchResult> results;
+    vector<DirectoryEntry> files = collectFileEntries();
+    if (pattern.empty()) return results;
+
+    vector<vector<uint32_t>> matches(files.size());
+    forEachFileParallel(files.size(), threads, [&](size_t i, istream& base, istream* delta) {
+        searchFileContent(files[i], pattern, base, delta, matches[i]);
+    });
+
+    // Resultados na ordem do diretório
+    for (size_t i = 0; i < files.size(); i++) {
+        if (matches[i].empty()) continue;
+        SearchResult result;
+        result.fileName = getFileName(files[i]);
+        result.offsets.swap(matches[i]);
+        results.push_back(result);
+    }
+    return results;
+}
+
+// Os últimos (tamanho do padrão - 1) bytes de cada extent ficam no headroom,
+// imediatamente antes dos dados do próximo, para encontrar ocorrências que
+// atravessam fronteiras de cluster
+void FAT16Manager::searchFileContent(const DirectoryEntry& entry, const string& pattern,
+                                     istream& base, istream* delta, vector<uint32_t>& matches) const {
+    uint32_t overlap = pattern.size() - 1;
+    uint32_t carried = 0;
+    vector<char> buffer;
+
+    readFileExtents(entry, base, delta, buffer, overlap, [&](uint32_t filePosition, uint32_t bytes) {
+        char* window = buffer.data() + overlap - carried;
+        findAllMatches(window, carried + bytes, pattern, filePosition - carried, matches);
+
+        uint32_t keep = min(overlap, carried + bytes);
+        memmove(buffer.data() + overlap - keep, window + carried + bytes - keep, keep);
+        carried = keep;
+    });
+}
+
+// ============================================================================
+// CHECKSUMS CRC32C E MANIFESTO DE INTEGRIDADE
+// ============================================================================
+// O manifesto é um arquivo texto ao lado da imagem, uma linha por arquivo:
+//   NOME.EXT tamanho primeiro_cluster crc32c(hex)
+// Nome, tamanho e primeiro cluster identificam a versão do arquivo: se algum
+// deles mudou, o arquivo foi alterado legitimamente (não é corrupção). Se os
+// três coincidem e o CRC não, os dados dos clusters foram corrompidos.
+// ============================================================================
+
+bool FAT16Manager::computeFileChecksum(const DirectoryEntry& entry, istream& base, istream* delta,
+                                       uint32_t& crc) const {
+    vector<char> buffer;
+    crc = 0;
+    return readFileExtents(entry, base, delta, buffer, 0, [&](uint32_t, uint32_t bytes) {
+        crc = crc32c(buffer.data(), bytes, crc);
+    });
+}
+
+bool FAT16Manager::writeChecksumManifest(const string& manifestPath, unsigned threads) {
+    TraceGuard trace(*this, TRACE_WRITE_CHECKSUMS, manifestPath);
+
+    vector<DirectoryEntry> files = collectFileEntries();
+    vector<uint32_t> crcs(files.size());
+    vector<char> complete(files.size());
+
+    forEachFileParallel(files.size(), threads, [&](size_t i, istream& base, istream* delta) {
+        complete[i] = computeFileChecksum(files[i], base, delta, crcs[i]);
+    });
+
+    ofstream manifest(manifestPath, ios::trunc);
+    if (!manifest.is_open()) {
+        cerr << "Erro: Não foi possível criar o manifesto: " << manifestPath << endl;
+        return false;
+    }
+    manifest << "# FAT16 CRC32C: nome tamanho primeiro_cluster crc32c\n";
+    for (size_t i = 0; i < files.size(); i++) {
+        if (!complete[i]) {
+            cerr << "Aviso: Cadeia de clusters incompleta em " << getFileName(files[i]) << endl;
+        }
+        manifest << getFileName(files[i]) << ' ' << files[i].fileSize << ' ' << files[i].firstClusterLow << ' '
+                 << hex << setw(8) << setfill('0') << crcs[i] << dec << setfill(' ') << '\n';
+    }
+    manifest.close();
+
+    cout << "Manifesto gravado em " << manifestPath << ": " << files.size() << " arquivo(s), CRC32C em "
+         << (crc32cHardwareAvailable() ? "hardware" : "software") << "." << endl;
+    trace.ok = manifest.good();
+    return trace.ok;
+}
+
+// Retorna o número de arquivos corrompidos, ou -1 se o manifesto não puder ser lido
+int FAT16Manager::verifyChecksumManifest(const string& manifestPath, unsigned threads) {
+    TraceGuard trace(*this, TRACE_VERIFY_CHECKSUMS, manifestPath);
+
+    ifstream manifest(manifestPath);
+    if (!manifest.is_open()) {
+        cerr << "Erro: Não foi possível abrir o manifesto: " << manifestPath << endl;
+        return -1;
+    }
+
+    struct ManifestEntry {
+        string name;
+        uint32_t size;
+        uint16_t firstCluster;
+        uint32_t crc;
+    };
+    vector<ManifestEntry> expected;
+    string line;
+    while (getline(manifest, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream fields(line);
+        ManifestEntry item;
+        if (fields >> item.name >> item.size >> item.firstCluster >> hex >> item.crc) {
+            expected.push_back(item);
+        }
+    }
+
+    // Seleciona os arquivos cuja identidade (nome/tamanho/cluster) não mudou
+    vector<DirectoryEntry> files = collectFileEntries();
+    vector<DirectoryEntry> toVerify;
+    vector<size_t> expectedIndex;
+    vector<char> seen(files.size(), 0);
+    int changed = 0;
+
+    for (size_t e = 0; e < expected.size(); e++) {
+        size_t match = files.size();
+        for (size_t i = 0; i < files.size(); i++) {
+            if (getFileName(files[i]) == expected[e].name) {
+                match = i;
+                break;
+            }
+        }
+        if (match == files.size()) {
+            cout << "AUSENTE    " << expected[e].name << endl;
+            changed++;
+            continue;
+        }
+        seen[match] = 1;
+        if (files[match].fileSize != expected[e].size || files[match].firstClusterLow != expected[e].firstCluster) {
+            cout << "ALTERADO   " << expected[e].name << endl;
+            changed++;
+            continue;
+        }
+        toVerify.push_back(files[match]);
+        expectedIndex.push_back(e);
+    }
+    for (size_t i = 0; i < files.size(); i++) {
+        if (!seen[i]) {
+            cout << "NOVO       " << getFileName(files[i]) << endl;
+            changed++;
+        }
+    }
+
+    vector<uint32_t> crcs(toVerify.size());
+    forEachFileParallel(toVerify.size(), threads, [&](size_t i, istream& base, istream* delta) {
+        computeFileChecksum(toVerify[i], base, delta, crcs[i]);
+    });
+
+    int corrupted = 0;
+    for (size_t i = 0; i < toVerify.size(); i++) {
+        const ManifestEntry& item = expected[expectedIndex[i]];
+        if (crcs[i] != item.crc) {
+            cout << "CORROMPIDO " << item.name << " (esperado " << hex << setw(8) << setfill('0') << item.crc
+                 << ", calculado " << setw(8) << crcs[i] << dec << setfill(' ') << ")" << endl;
+            corrupted++;
+        }
+    }
+
+    cout << "Verificação: " << toVerify.size() - corrupted << " íntegro(s), " << corrupted
+         << " corrompido(s), " << changed << " alterado(s)/ausente(s)/novo(s)." << endl;
+    trace.ok = (corrupted == 0);
+    return corrupted;
+}
+
+// ============================================================================
+// EXPORTAÇÃO E IMPORTAÇÃO TAR (ustar)
+// ============================================================================
+// Cada arquivo vira um cabeçalho de 512 bytes seguido do conteúdo, completado
+// com zeros até múltiplo de 512; o fluxo termina com dois blocos zerados.
+// Campos numéricos são octais em ASCII. O mtime vem de lastModifiedDate/Time
+// (hora local, como em createFile) e o modo reflete o ATTR_READ_ONLY.
+// A importação lê o conteúdo direto do fluxo para os clusters e roda dentro
+// de um lote: FAT e diretório raiz são gravados uma vez, no final.
+// ============================================================================
+
+#pragma pack(push, 1)
+struct TarHeader {
+    char name[100];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char checksum[8];
+    char typeflag;
+    char linkname[100];
+    char magic[6];                 // "ustar\0"
+    char version[2];               // "00"
+    char uname[32];
+    char gname[32];
+    char devmajor[8];
+    char devminor[8];
+    char prefix[155];
+    char padding[12];
+};
+#pragma pack(pop)
+
+static void writeOctal(char* field, size_t width, uint64_t value) {
+    snprintf(field, width, "%0*llo", static_cast<int>(width - 1), static_cast<unsigned long long>(value));
+}
+
+static uint64_t parseOctal(const char* field, size_t width) {
+    uint64_t value = 0;
+    size_t i = 0;
+    while (i < width && field[i] == ' ') i++;
+    for (; i < width && field[i] >= '0' && field[i] <= '7'; i++) {
+        value = value * 8 + (field[i] - '0');
+    }
+    return value;
+}
+
+// Soma dos bytes do cabeçalho com o campo checksum contando como espaços
+static uint32_t tarChecksum(const TarHeader& header) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+    uint32_t sum = 0;
+    for (size_t i = 0; i < sizeof(TarHeader); i++) {
+        bool inChecksum = i >= offsetof(TarHeader, checksum) && i < offsetof(TarHeader, typeflag);
+        sum += inChecksum ? ' ' : bytes[i];
+    }
+    return sum;
+}
+
+void FAT16Manager::toFATDateTime(time_t moment, uint16_t& date, uint16_t& time) {
+    struct tm* timeInfo = localtime(&moment);
+    if (!timeInfo || timeInfo->tm_year < 80) {
+        date = (1 << 5) | 1;    // 01/01/1980: menor data representável
+        time = 0;
+        return;
+    }
+    date = ((timeInfo->tm_year - 80) << 9) | ((timeInfo->tm_mon + 1) << 5) | timeInfo->tm_mday;
+    time = (timeInfo->tm_hour << 11) | (timeInfo->tm_min << 5) | (timeInfo->tm_sec / 2);
+}
+
+time_t FAT16Manager::fromFATDateTime(uint16_t date, uint16_t time) {
+    struct tm timeInfo;
+    memset(&timeInfo, 0, sizeof(timeInfo));
+    timeInfo.tm_year = ((date >> 9) & 0x7F) + 80;
+    timeInfo.tm_mon = ((date >> 5) & 0x0F) - 1;
+    timeInfo.tm_mday = date & 0x1F;
+    timeInfo.tm_hour = (time >> 11) & 0x1F;
+    timeInfo.tm_min = (time >> 5) & 0x3F;
+    timeInfo.tm_sec = (time & 0x1F) * 2;
+    timeInfo.tm_isdst = -1;
+    time_t result = mktime(&timeInfo);
+    return result == static_cast<time_t>(-1) ? 0 : result;
+}
+
+bool FAT16Manager::exportTar(ostream& out) {
+    TraceGuard trace(*this, TRACE_EXPORT_TAR);
+    static const char zeros[512] = {};
+    vector<char> buffer;
+    istream* delta = deltaFile.is_open() ? &deltaFile : nullptr;
+
+    for (const DirectoryEntry& entry : collectFileEntries()) {
+        TarHeader header;
+        memset(&header, 0, sizeof(header));
+        string name = getFileName(entry);
+        memcpy(header.name, name.data(), min(name.size(), sizeof(header.name)));
+        writeOctal(header.mode, sizeof(header.mode), (entry.attributes & ATTR_READ_ONLY) ? 0444 : 0644);
+        writeOctal(header.uid, sizeof(header.uid), 0);
+        writeOctal(header.gid, sizeof(header.gid), 0);
+        writeOctal(header.size, sizeof(header.size), entry.fileSize);
+        writeOctal(header.mtime, sizeof(header.mtime),
+                   fromFATDateTime(entry.lastModifiedDate, entry.lastModifiedTime));
+        header.typeflag = '0';
+        memcpy(header.magic, "ustar", 6);
+        memcpy(header.version, "00", 2);
+        snprintf(header.checksum, sizeof(header.checksum), "%06o", tarChecksum(header));
+        header.checksum[7] = ' ';
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        // Conteúdo em extents (clusters consecutivos numa única leitura)
+        bool ok = readFileExtents(entry, imageFile, delta, buffer, 0, [&](uint32_t, uint32_t bytes) {
+            out.write(buffer.data(), bytes);
+        });
+        if (!ok) {
+            cerr << "Erro: Falha ao ler o arquivo '" << name << "'." << endl;
+            return false;
+        }
+        out.write(zeros, (512 - entry.fileSize % 512) % 512);
+    }
+
+    // Fim do arquivo tar: dois blocos zerados
+    out.write(zeros, sizeof(zeros));
+    out.write(zeros, sizeof(zeros));
+    out.flush();
+    trace.ok = out.good();
+    return trace.ok;
+}
+
+int FAT16Manager::importTar(istream& in) {
+    TraceGuard trace(*this, TRACE_IMPORT_TAR);
+    int imported = 0;
+    bool malformed = false;
+    TarHeader header;
+
+    // Metadados de antes da importação: um fluxo inválido desfaz o lote inteiro
+    vector<uint16_t> fatBefore = fat;
+    vector<DirectoryEntry> rootBefore = rootDirectory;
+
+    beginBatch();
+    while (true) {
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (in.gcount() == 0) break;                        // Fim sem os blocos zerados
+        if (in.gcount() != sizeof(header)) {
+            malformed = true;
+            break;
+        }
+
+        const char* bytes = reinterpret_cast<const char*>(&header);
+        if (bytes[0] == 0 && memcmp(bytes, bytes + 1, sizeof(header) - 1) == 0) break;
+
+        if (parseOctal(header.checksum, sizeof(header.checksum)) != tarChecksum(header)) {
+            malformed = true;
+            break;
+        }
+
+        uint64_t size = parseOctal(header.size, sizeof(header.size));
+        uint64_t padded = (size + 511) / 512 * 512;
+
+        // Só arquivos regulares; diretórios e links são ignorados. O diretório
+        // raiz é plano, então apenas o último componente do caminho é usado
+        string name(header.name, strnlen(header.name, sizeof(header.name)));
+        size_t slash = name.find_last_of('/');
+        if (slash != string::npos) name = name.substr(slash + 1);
+
+        bool regular = (header.typeflag == '0' || header.typeflag == '\0') && !name.empty();
+        if (regular && size > 0xFFFFFFFFull) {
+            cerr << "Erro: '" << name << "' é grande demais para o FAT16." << endl;
+            regular = false;
+        }
+
+        // createFileFromStream só consome o fluxo quando nome, espaço e
+        // diretório são aceitos; um membro truncado esgota o fluxo, não vira
+        // entrada e marca o tar como inválido logo abaixo
+        uint64_t consumed = 0;
+        if (regular) {
+            uint32_t mode = static_cast<uint32_t>(parseOctal(header.mode, sizeof(header.mode)));
+            uint8_t attributes = (mode & 0200) ? 0 : ATTR_READ_ONLY;
+            if (createFileFromStream(in, static_cast<uint32_t>(size), name, attributes)) {
+                uint16_t date, time;
+                toFATDateTime(static_cast<time_t>(parseOctal(header.mtime, sizeof(header.mtime))), date, time);
+                DirectoryEntry* entry = findFileEntry(name);
+                entry->lastModifiedDate = date;
+                entry->lastModifiedTime = time;
+                consumed = size;
+                imported++;
+            }
+        }
+        in.ignore(static_cast<streamsize>(padded - consumed));
+        if (!in.good()) {
+            malformed = true;
+            break;
+        }
+    }
+    if (malformed) {
+        // Dentro do lote só os clusters de dados foram gravados; restaurar a
+        // FAT e o diretório em memória os devolve como livres
+        fat = fatBefore;
+        rootDirectory = rootBefore;
+    }
+    if (!commitBatch() && !malformed) {
+        cerr << "Erro: Falha ao gravar a FAT e o diretório raiz na imagem." << endl;
+        return -1;
+    }
+
+    if (malformed) {
+        cerr << "Erro: Fluxo tar inválido ou truncado; nenhum arquivo foi importado." << endl;
+        return -1;
+    }
+    cout << imported << " arquivo(s) importado(s)." << endl;
+    trace.ok = true;
+    return imported;
 }
 
-// Lista os arquivos no diretório raiz do FAT16
-void FAT16Manager::listFiles() {
-    cout << "\n========== CONTEÚDO DO DISCO ==========\n";
-    cout << left << setw(20) << "Nome do Arquivo" 
-         << right << setw(15) << "Tamanho (bytes)" << endl;
-    cout << string(35, '-') << endl;
+// ============================================================================
+// SINCRONIZAÇÃO INCREMENTAL A PARTIR DE UM DIRETÓRIO DO HOST
+// ============================================================================
+// Compara os arquivos regulares de um diretório do host com o diretório raiz:
+//   - ausente na imagem                  -> cria
+//   - tamanho ou data/hora diferentes    -> substitui (cria a cópia com nome
+//                                           temporário, apaga a antiga e renomeia)
+//   - presente só na imagem              -> apaga
+// A data/hora do host é convertida para o formato FAT (precisão de 2 s) antes
+// da comparação. Com compareContent, o CRC32C decide: conteúdo igual com data
+// diferente só atualiza a data na entrada. Tudo roda num único lote, então o
+// custo de metadados é um saveFAT/saveRootDirectory independente do número
+// de arquivos alterados.
+// ============================================================================
 
-    int fileCount = 0;
-    for (const auto& entry : rootDirectory) {
-        if (entry.fileName[0] == 0x00) break;
-        if (static_cast<uint8_t>(entry.fileName[0]) == 0xE5) continue;
-        if (entry.attributes & ATTR_VOLUME_ID) continue;
-        if (entry.attributes & ATTR_DIRECTORY) continue;
+struct HostFile {
+    string name;
+    string path;
+    uint64_t size;
+    time_t modified;
+};
 
-        string fileName = getFileName(entry);
-        cout << left << setw(20) << fileName 
-             << right << setw(15) << entry.fileSize << endl;
-        fileCount++;
+// Lista os arquivos regulares (sem subdiretórios) de um diretório do host
+static bool listHostDirectory(const string& dir, vector<HostFile>& files) {
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE handle = FindFirstFileA((dir + "\\*").c_str(), &data);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    do {
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+        ULARGE_INTEGER size, written;
+        size.LowPart = data.nFileSizeLow;
+        size.HighPart = data.nFileSizeHigh;
+        written.LowPart = data.ftLastWriteTime.dwLowDateTime;
+        written.HighPart = data.ftLastWriteTime.dwHighDateTime;
+        // FILETIME: intervalos de 100 ns desde 1601
+        time_t modified = static_cast<time_t>(written.QuadPart / 10000000ULL - 11644473600ULL);
+        files.push_back({ data.cFileName, dir + "\\" + data.cFileName, size.QuadPart, modified });
+    } while (FindNextFileA(handle, &data));
+    FindClose(handle);
+#else
+    DIR* handle = opendir(dir.c_str());
+    if (!handle) return false;
+    while (struct dirent* item = readdir(handle)) {
+        string path = dir + "/" + item->d_name;
+        struct stat fileStat;
+        if (stat(path.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) continue;
+        files.push_back({ item->d_name, path, static_cast<uint64_t>(fileStat.st_size), fileStat.st_mtime });
     }
-    
-    if (fileCount == 0) {
-        cout << "Nenhum arquivo encontrado no diretório raiz." << endl;
+    closedir(handle);
+#endif
+    return true;
+}
+
+static bool hostFileChecksum(const string& path, uint32_t& crc) {
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) return false;
+    vector<char> buffer(1 << 20);
+    crc = 0;
+    while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0) {
+        crc = crc32c(buffer.data(), static_cast<size_t>(in.gcount()), crc);
     }
-    cout << "\nTotal de arquivos: " << fileCount << endl;
-    cout << "========================================\n" << endl;
+    return in.eof();
 }
 
-// Exibe o conteúdo de um arquivo
-// Implementa a operação de leitura sequencial de arquivo
-// Segue a cadeia de clusters na FAT
-void FAT16Manager::showFileContent(const string& fileName) {
-    DirectoryEntry* entry = findFileEntry(fileName);
-    
-    if (!entry) {
-        cerr << "Erro: Arquivo '" << fileName << "' não encontrado." << endl;
-        return;
+int FAT16Manager::syncFromDirectory(const string& hostDir, bool compareContent) {
+    TraceGuard trace(*this, TRACE_SYNC_DIRECTORY, hostDir, compareContent ? "content" : "metadata");
+    vector<HostFile> hostFiles;
+    if (!listHostDirectory(hostDir, hostFiles)) {
+        cerr << "Erro: Não foi possível abrir o diretório: " << hostDir << endl;
+        return -1;
     }
-    
-    if (entry->fileSize == 0) {
-        cout << "\nArquivo vazio." << endl;
-        return;
+
+    vector<string> hostNames;
+    for (const HostFile& file : hostFiles) {
+        string upper = file.name;
+        transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        hostNames.push_back(upper);
     }
+    sort(hostNames.begin(), hostNames.end());
 
-    cout << "\n========== CONTEÚDO DO ARQUIVO: " << fileName << " ==========\n";
+    int created = 0, replaced = 0, removed = 0, touched = 0, unchanged = 0, failed = 0;
+    istream* delta = deltaFile.is_open() ? &deltaFile : nullptr;
 
-    // Obtém o primeiro cluster do arquivo (início da cadeia)
-    uint16_t cluster = entry->firstClusterLow;
-    uint32_t remainingBytes = entry->fileSize;
-    uint32_t clusterSize = bootSector.sectorsPerCluster * bootSector.bytesPerSector;
+    beginBatch();
 
-    vector<char> buffer(clusterSize);
+    // Apaga primeiro o que não existe mais no host, liberando espaço
+    for (const DirectoryEntry& image : collectFileEntries()) {
+        string name = getFileName(image);
+        transform(name.begin(), name.end(), name.begin(), ::toupper);
+        if (!binary_search(hostNames.begin(), hostNames.end(), name)) {
+            uint64_t released;
+            removeFileEntry(*findFileEntry(name), released);   // No lote: só em memória
+            cout << "Apagado: " << name << endl;
+            removed++;
+        }
+    }
 
-    // Percorre a linked list de clusters na FAT
-    // Cada cluster aponta para o próximo até encontrar EOF (0xFFF8-0xFFFF)
-    while (cluster >= 2 && cluster < FAT_EOF_MARKER && remainingBytes > 0) {
-        // Calcula onde está este cluster no disco
-        uint32_t offset = getClusterOffset(cluster);
-        uint32_t bytesToRead = min(remainingBytes, clusterSize);
+    for (const HostFile& file : hostFiles) {
+        uint16_t date, time;
+        toFATDateTime(file.modified, date, time);
 
-        // Lê o conteúdo do cluster
-        imageFile.seekg(offset, ios::beg);
-        imageFile.read(buffer.data(), bytesToRead);
-        
-        // Exibe o conteúdo
-        for (uint32_t i = 0; i < bytesToRead; i++) {
-            cout << buffer[i];
+        DirectoryEntry* entry = findFileEntry(file.name);
+        bool exists = entry != nullptr;
+        if (exists && entry->fileSize == file.size) {
+            bool sameTime = entry->lastModifiedDate == date && entry->lastModifiedTime == time;
+            if (!compareContent && sameTime) {
+                unchanged++;
+                continue;
+            }
+            uint32_t imageCrc, hostCrc;
+            if (compareContent && computeFileChecksum(*entry, imageFile, delta, imageCrc) &&
+                hostFileChecksum(file.path, hostCrc) && imageCrc == hostCrc) {
+                if (sameTime) {
+                    unchanged++;
+                } else {
+                    // Mesmo conteúdo: só a data da entrada é atualizada
+                    entry->lastModifiedDate = date;
+                    entry->lastModifiedTime = time;
+                    saveMetadata();
+                    touched++;
+                }
+                continue;
+            }
         }
-        
-        remainingBytes -= bytesToRead;
-        
-        // Busca o próximo cluster na cadeia (follow the pointer)
-        cluster = fat[cluster];
-    }
 
-    cout << "\n========================================\n" << endl;
-}
+        if (file.size > 0xFFFFFFFFull) {
+            cerr << "Erro: '" << file.name << "' é grande demais para o FAT16." << endl;
+            failed++;
+            continue;
+        }
+        ifstream source(file.path, ios::binary);
+        if (!source.is_open()) {
+            cerr << "Erro: Não foi possível abrir o arquivo fonte: " << file.path << endl;
+            failed++;
+            continue;
+        }
+        if (!exists) {
+            if (!createFileFromStream(source, static_cast<uint32_t>(file.size), file.name,
+                                      hostFileAttributes(file.path))) {
+                failed++;
+                continue;
+            }
+        } else {
+            // Substituição: a cópia nova é criada com um nome temporário e só
+            // toma o lugar da antiga depois de completa. Uma falha (disco
+            // cheio, erro de leitura no host) deixa o arquivo original intacto
+            string tempName;
+            for (int i = 0; i < 1000 && (tempName.empty() || findFileEntry(tempName)); i++) {
+                char candidate[13];
+                snprintf(candidate, sizeof(candidate), "~SYNC%03d.TMP", i);
+                tempName = candidate;
+            }
+            FAT16Status status = createFileCore(source, static_cast<uint32_t>(file.size), tempName,
+                                                hostFileAttributes(file.path));
+            if (status != FAT16_OK) {
+                printStatus(status, file.name);
+                failed++;
+                continue;
+            }
+            uint64_t released;
+            removeFileEntry(*findFileEntry(file.name), released);
+            setFileName(*findFileEntry(tempName), file.name);
+            saveMetadata();
+            cout << "Substituído: " << file.name << endl;
+        }
 
-// Exibe os atributos e metadados de um arquivo
-void FAT16Manager::showFileAttributes(const string& fileName) {
-    DirectoryEntry* entry = findFileEntry(fileName);
-    
-    if (!entry) {
-        cerr << "Erro: Arquivo '" << fileName << "' não encontrado." << endl;
-        return;
+        // A data de modificação do host torna a próxima sincronização incremental
+        entry = findFileEntry(file.name);
+        entry->lastModifiedDate = date;
+        entry->lastModifiedTime = time;
+        exists ? replaced++ : created++;
     }
 
-    cout << "\n========== ATRIBUTOS DO ARQUIVO: " << fileName << " ==========\n";
-    cout << "Nome completo: " << getFileName(*entry) << endl;
-    cout << "Tamanho: " << entry->fileSize << " bytes" << endl;
-    cout << "\nDatas e Horários:" << endl;
-    cout << "  Criação:           " << formatDate(entry->creationDate) << " " << formatTime(entry->creationTime) << endl;
-    cout << "  Última modificação: " << formatDate(entry->lastModifiedDate) << " " << formatTime(entry->lastModifiedTime) << endl;
-    cout << "  Último acesso:      " << formatDate(entry->lastAccessDate) << endl;
+    if (!commitBatch()) {
+        cerr << "Erro: Falha ao gravar a FAT e o diretório raiz na imagem." << endl;
+        failed++;
+    }
 
-    cout << "\nAtributos:" << endl;
-    cout << "  Somente leitura: " << ((entry->attributes & ATTR_READ_ONLY) ? "SIM" : "NÃO") << endl;
-    cout << "  Oculto:          " << ((entry->attributes & ATTR_HIDDEN) ? "SIM" : "NÃO") << endl;
-    cout << "  Arquivo sistema: " << ((entry->attributes & ATTR_SYSTEM) ? "SIM" : "NÃO") << endl;
-    cout << "  Arquivo:         " << ((entry->attributes & ATTR_ARCHIVE) ? "SIM" : "NÃO") << endl;
+    cout << "Sincronização: " << created << " criado(s), " << replaced << " substituído(s), "
+         << removed << " apagado(s), " << touched << " com data atualizada, "
+         << unchanged << " inalterado(s)";
+    if (failed > 0) {
+        cout << ", " << failed << " com erro";
+    }
+    cout << "." << endl;
 
-    cout << "\nInformações técnicas:" << endl;
-    cout << "  Primeiro cluster: " << entry->firstClusterLow << endl;
-    cout << "========================================\n" << endl;
+    trace.ok = (failed == 0);
+    return failed == 0 ? created + replaced + removed + touched : -1;
 }
 
 // Renomeia um arquivo no sistema de arquivos FAT16
 bool FAT16Manager::renameFile(const string& oldName, const string& newName) {
-    DirectoryEntry* entry = findFileEntry(oldName);
-    
-    if (!entry) {
-        cerr << "Erro: Arquivo '" << oldName << "' não encontrado." << endl;
+    TraceGuard trace(*this, TRACE_RENAME_FILE, oldName, newName);
+    FAT16Status status = renameFileCore(oldName, newName);
+    if (status != FAT16_OK) {
+        printStatus(status, status == FAT16_NOT_FOUND ? oldName : newName);
         return false;
     }
-    
-    if (findFileEntry(newName)) {
-        cerr << "Erro: Já existe um arquivo com o nome '" << newName << "'." << endl;
-        return false;
-    }
-    
-    size_t dotPos = newName.find('.');
-    if (dotPos != string::npos) {
-        string baseName = newName.substr(0, dotPos);
-        string ext = newName.substr(dotPos + 1);
 
-        if (baseName.length() > 8 || ext.length() > 3) {
-            cerr << "Erro: Nome inválido. Formato: até 8 caracteres.até 3 caracteres" << endl;
-            return false;
-        }
-    } else {
-        if (newName.length() > 8) {
-            cerr << "Erro: Nome muito longo (máximo 8 caracteres sem extensão)." << endl;
-            return false;
-        }
-    }
+    cout << "Arquivo renomeado com sucesso: '" << oldName << "' -> '" << newName << "'" << endl;
+    trace.ok = true;
+    return true;
+}
+
+// Núcleo do renomear, sem saída no console
+FAT16Status FAT16Manager::renameFileCore(const string& oldName, const string& newName) {
+    DirectoryEntry* entry = findFileEntry(oldName);
+    if (!entry) return FAT16_NOT_FOUND;
+    if (findFileEntry(newName)) return FAT16_ALREADY_EXISTS;
+
+    FAT16Status status = validateFileName(newName);
+    if (status != FAT16_OK) return status;
     
     setFileName(*entry, newName);
     
@@ -436,49 +2710,78 @@ bool FAT16Manager::renameFile(const string& oldName, const string& newName) {
     entry->lastModifiedDate = date;
     entry->lastModifiedTime = timeVal;
     
-    saveRootDirectory();
-
-    cout << "Arquivo renomeado com sucesso: '" << oldName << "' -> '" << newName << "'" << endl;
-    return true;
+    return saveRootDirectory() ? FAT16_OK : FAT16_IO_ERROR;
 }
 
 // Remove um arquivo do sistema de arquivos
 // Implementa a operação de deleção (unlink)
 // Libera os clusters na FAT e marca a entrada do diretório como deletada
 bool FAT16Manager::deleteFile(const string& fileName) {
+    TraceGuard trace(*this, TRACE_DELETE_FILE, fileName);
     DirectoryEntry* entry = findFileEntry(fileName);
     
     if (!entry) {
-        cerr << "Erro: Arquivo '" << fileName << "' não encontrado." << endl;
+        printStatus(FAT16_NOT_FOUND, fileName);
         return false;
     }
     
+    uint64_t released;
+    FAT16Status status = removeFileEntry(*entry, released);
+    if (status != FAT16_OK) {
+        printStatus(status, fileName);
+        return false;
+    }
+
+    cout << "Arquivo '" << fileName << "' removido com sucesso." << endl;
+    if (released > 0) {
+        cout << released << " bytes devolvidos ao sistema de arquivos do host." << endl;
+    }
+    trace.ok = true;
+    return true;
+}
+
+// Núcleo da deleção: libera a cadeia, marca a entrada como apagada e persiste.
+// released recebe quantos bytes voltaram para o host (modo discard)
+FAT16Status FAT16Manager::removeFileEntry(DirectoryEntry& entry, uint64_t& released) {
+    released = 0;
     // Percorre a cadeia de clusters e marca cada um como livre
     // Libera os blocos para reutilização (dealocação)
-    uint16_t cluster = entry->firstClusterLow;
+    uint16_t cluster = entry.firstClusterLow;
+    vector<uint16_t> freedClusters;
     while (cluster >= 2 && cluster < FAT_EOF_MARKER) {
         uint16_t nextCluster = fat[cluster];  // Salva o próximo antes de limpar
         fat[cluster] = FAT_FREE_CLUSTER;      // Marca como livre (0x0000)
+        if (discardEnabled) freedClusters.push_back(cluster);
         cluster = nextCluster;
     }
     
     // Marca a entrada do diretório como deletada (soft delete)
     // 0xE5 no primeiro byte indica que o espaço pode ser reutilizado
     // Os dados ainda existem no disco até serem sobrescritos
-    entry->fileName[0] = static_cast<char>(0xE5);
+    entry.fileName[0] = static_cast<char>(0xE5);
     
-    // Persiste as mudanças no disco
-    saveFAT();
-    saveRootDirectory();
-
-    cout << "Arquivo '" << fileName << "' removido com sucesso." << endl;
-    return true;
+    // Persiste as mudanças no disco. Se a FAT não foi gravada, os clusters
+    // ainda podem constar como usados no disco e não viram buraco
+    if (!saveMetadata()) return FAT16_IO_ERROR;
+    
+    // Só depois da FAT persistida o espaço é devolvido ao host
+    // (dentro de um lote, isso fica para o commitBatch)
+    if (batchDepth > 0) {
+        batchFreedClusters.insert(batchFreedClusters.end(), freedClusters.begin(), freedClusters.end());
+    } else {
+        released = releaseClusters(freedClusters);
+        
+        // A entrada não é mais usada a partir daqui: pode compactar
+        autoCompactRootDirectory();
+    }
+    return FAT16_OK;
 }
 
 // Cria um novo arquivo no sistema FAT16 copiando de um arquivo externo
 // Implementa as operações de create + write
 // Envolve: alocação de clusters, criação de entrada de diretório, e escrita de dados
 bool FAT16Manager::createFile(const string& sourcePath, const string& destName) {
+    TraceGuard trace(*this, TRACE_CREATE_FILE, sourcePath, destName);
     // Abre o arquivo fonte (do sistema de arquivos hospedeiro)
     ifstream sourceFile(sourcePath, ios::binary);
     if (!sourceFile.is_open()) {
@@ -490,39 +2793,84 @@ bool FAT16Manager::createFile(const string& sourcePath, const string& destName)
     sourceFile.seekg(0, ios::end);
     uint32_t fileSize = sourceFile.tellg();
     sourceFile.seekg(0, ios::beg);
-    
-    // Verifica se já existe arquivo com este nome (nomes devem ser únicos)
-    if (findFileEntry(destName)) {
-        cerr << "Erro: Já existe um arquivo com o nome '" << destName << "'." << endl;
-        sourceFile.close();
-        return false;
+
+    uint8_t hostAttributes = hostFileAttributes(sourcePath);
+    trace.ok = createFileFromStream(sourceFile, fileSize, destName, hostAttributes);
+    if (trace.ok && (hostAttributes & ATTR_READ_ONLY)) {
+        cout << "Arquivo marcado como somente leitura." << endl;
     }
-    
-    // Valida o nome do arquivo (formato 8.3)
-    size_t dotPos = destName.find('.');
-    if (dotPos != string::npos) {
-        string baseName = destName.substr(0, dotPos);
-        string ext = destName.substr(dotPos + 1);
+    return trace.ok;
+}
 
-        if (baseName.length() > 8 || ext.length() > 3) {
-            cerr << "Erro: Nome inválido. Formato: até 8 caracteres.até 3 caracteres" << endl;
-            sourceFile.close();
-            return false;
+// Preserva atributos do arquivo original (mapeamento de permissões)
+// Traduz permissões do sistema hospedeiro para atributos FAT16
+uint8_t FAT16Manager::hostFileAttributes(const string& sourcePath) {
+    uint8_t hostAttributes = 0;
+#ifdef _WIN32
+    DWORD attrs = GetFileAttributesA(sourcePath.c_str());
+    if (attrs != INVALID_FILE_ATTRIBUTES) {
+        if (attrs & FILE_ATTRIBUTE_READONLY) {
+            hostAttributes |= ATTR_READ_ONLY;  // Somente leitura
         }
-    } else {
-        if (destName.length() > 8) {
-            cerr << "Erro: Nome muito longo (máximo 8 caracteres sem extensão)." << endl;
-            sourceFile.close();
-            return false;
+        if (attrs & FILE_ATTRIBUTE_HIDDEN) {
+            hostAttributes |= ATTR_HIDDEN;  // Oculto
+        }
+        if (attrs & FILE_ATTRIBUTE_SYSTEM) {
+            hostAttributes |= ATTR_SYSTEM;  // Arquivo de sistema
         }
     }
-    
-    int freeEntryIndex = findFreeDirectoryEntry();
-    if (freeEntryIndex == -1) {
-        cerr << "Erro: Diretório raiz está cheio." << endl;
-        sourceFile.close();
+#else
+    // Para sistemas Unix/Linux - mapeia permissões POSIX para atributos FAT16
+    struct stat fileStat;
+    if (stat(sourcePath.c_str(), &fileStat) == 0) {
+        // Se o arquivo não tem permissão de escrita para o dono (chmod -w)
+        if (!(fileStat.st_mode & S_IWUSR)) {
+            hostAttributes |= ATTR_READ_ONLY;
+        }
+    }
+#endif
+    return hostAttributes;
+}
+
+// Cria um arquivo a partir de um buffer em memória (sem arquivo no host)
+bool FAT16Manager::createFileFromBuffer(const string& destName, const char* data, uint32_t size) {
+    string sizeArg = to_string(size);
+    TraceGuard trace(*this, TRACE_CREATE_FROM_BUFFER, destName, sizeArg);
+
+    istringstream source(string(data, size));
+    trace.ok = createFileFromStream(source, size, destName, 0);
+    return trace.ok;
+}
+
+// Cria o arquivo a partir de um fluxo e informa o resultado no console
+bool FAT16Manager::createFileFromStream(istream& sourceFile, uint32_t fileSize, const string& destName,
+                                        uint8_t extraAttributes) {
+    FAT16Status status = createFileCore(sourceFile, fileSize, destName, extraAttributes);
+    if (status != FAT16_OK) {
+        printStatus(status, destName);
         return false;
     }
+    cout << "Arquivo '" << destName << "' criado com sucesso (" << fileSize << " bytes)." << endl;
+    return true;
+}
+
+// Núcleo da criação de arquivo: aloca clusters, copia fileSize bytes de source
+// e cria a entrada de diretório com os atributos extras informados.
+// O fluxo só é consumido quando nome, espaço e diretório são aceitos; se ele
+// terminar antes de fileSize bytes, nada é criado e o retorno é FAT16_IO_ERROR.
+FAT16Status FAT16Manager::createFileCore(istream& sourceFile, uint32_t fileSize, const string& destName,
+                                         uint8_t extraAttributes) {
+    uint32_t totalSize = fileSize;
+    
+    // Verifica se já existe arquivo com este nome (nomes devem ser únicos)
+    if (findFileEntry(destName)) return FAT16_ALREADY_EXISTS;
+    
+    // Valida o nome do arquivo (formato 8.3)
+    FAT16Status status = validateFileName(destName);
+    if (status != FAT16_OK) return status;
+    
+    int freeEntryIndex = findFreeDirectoryEntry();
+    if (freeEntryIndex == -1) return FAT16_DIRECTORY_FULL;
     
     // Calcula quantos clusters são necessários para armazenar o arquivo
     // Unidade de alocação = cluster
@@ -540,13 +2888,10 @@ bool FAT16Manager::createFile(const string& sourcePath, const string& destName)
         uint16_t cluster = findFreeCluster();
         if (cluster == 0) {
             // Disco cheio - faz rollback da alocação
-            cerr << "Erro: Não há espaço suficiente no disco." << endl;
-
             for (uint16_t c : allocatedClusters) {
                 fat[c] = FAT_FREE_CLUSTER;  // Libera clusters já alocados
             }
-            sourceFile.close();
-            return false;
+            return FAT16_DISK_FULL;
         }
         allocatedClusters.push_back(cluster);
         fat[cluster] = FAT_EOF_MARKER;  // Marca temporariamente como EOF
@@ -554,7 +2899,7 @@ bool FAT16Manager::createFile(const string& sourcePath, const string& destName)
     
     // Constrói a cadeia de clusters na FAT
     // Cada cluster aponta para o próximo, exceto o último que tem EOF
-    for (size_t i = 0; i < allocatedClusters.size() - 1; i++) {
+    for (size_t i = 0; i + 1 < allocatedClusters.size(); i++) {
         fat[allocatedClusters[i]] = allocatedClusters[i + 1];  // cluster[i] -> cluster[i+1]
     }
     if (!allocatedClusters.empty()) {
@@ -563,29 +2908,50 @@ bool FAT16Manager::createFile(const string& sourcePath, const string& destName)
 
     // FASE DE ESCRITA - Copia dados do arquivo fonte para os clusters alocados
     // Operação de leitura e escrita em blocos
-    vector<char> buffer(clusterSize);
-    for (uint16_t cluster : allocatedClusters) {
-        uint32_t bytesToRead = min(fileSize, clusterSize);
+    uint32_t copied = 0;
+    bool written = true;
+    if (asyncIO.isOpen()) {
+        // Modo assíncrono: janelas de queueDepth clusters submetidas em lote
+        written = writeChainAsync(sourceFile, allocatedClusters, fileSize, copied);
+    } else {
+        PooledBuffer buffer(bufferPool);
+        for (uint16_t cluster : allocatedClusters) {
+            uint32_t bytesToRead = min(fileSize, clusterSize);
         
-        // Lê dados do arquivo fonte
-        sourceFile.read(buffer.data(), bytesToRead);
-        uint32_t bytesRead = sourceFile.gcount();
+            // Lê dados do arquivo fonte
+            sourceFile.read(buffer.data(), bytesToRead);
+            uint32_t bytesRead = sourceFile.gcount();
         
-        // Preenche o resto do cluster com zeros (padding)
-        // Clusters são sempre escritos completos por questões de alinhamento
-        if (bytesRead < clusterSize) {
-            memset(buffer.data() + bytesRead, 0, clusterSize - bytesRead);
-        }
+            // Preenche o resto do cluster com zeros (padding)
+            // Clusters são sempre escritos completos por questões de alinhamento
+            if (bytesRead < clusterSize) {
+                memset(buffer.data() + bytesRead, 0, clusterSize - bytesRead);
+            }
         
-        // Escreve o cluster no disco
-        uint32_t offset = getClusterOffset(cluster);
-        imageFile.seekp(offset, ios::beg);
-        imageFile.write(buffer.data(), clusterSize);
+            // Escreve o cluster no disco
+            // No modo discard, um cluster todo zerado vira um buraco (lê como zeros)
+            // em vez de ocupar espaço no host; no overlay o buraco exporia a base
+            uint32_t offset = getClusterOffset(cluster);
+            bool zeroCluster = discardEnabled && deltaFileName.empty() &&
+                               buffer.data()[0] == 0 && memcmp(buffer.data(), buffer.data() + 1, clusterSize - 1) == 0;
+            if (!zeroCluster || !punchHole(offset, clusterSize)) {
+                written = writeCluster(cluster, buffer.data()) && written;
+            }
         
-        fileSize -= bytesRead;
+            fileSize -= bytesRead;
+            copied += bytesRead;
+        }
+    }
+
+    // Fonte mais curta que o tamanho declarado (ex.: membro truncado de um
+    // tar) ou falha ao gravar os dados: desfaz a alocação em vez de criar
+    // uma entrada com lixo no conteúdo
+    if (copied != totalSize || !written) {
+        for (uint16_t c : allocatedClusters) {
+            fat[c] = FAT_FREE_CLUSTER;
+        }
+        return FAT16_IO_ERROR;
     }
-    
-    sourceFile.close();
     
     // FASE DE METADADOS - Cria a entrada de diretório
     // Contém informações sobre o arquivo: nome, tamanho, datas, atributos, primeiro cluster
@@ -597,35 +2963,7 @@ bool FAT16Manager::createFile(const string& sourcePath, const string& destName)
 
     // Define atributos do arquivo (permissões simplificadas)
     // Archive bit indica que o arquivo foi modificado (para backup)
-    newEntry.attributes = ATTR_ARCHIVE;
-
-    // Preserva atributos do arquivo original (mapeamento de permissões)
-    // Traduz permissões do sistema hospedeiro para atributos FAT16
-#ifdef _WIN32
-    DWORD attrs = GetFileAttributesA(sourcePath.c_str());
-    if (attrs != INVALID_FILE_ATTRIBUTES) {
-        if (attrs & FILE_ATTRIBUTE_READONLY) {
-            newEntry.attributes |= ATTR_READ_ONLY;  // Somente leitura
-            std::cout << "Arquivo marcado como somente leitura." << std::endl;
-        }
-        if (attrs & FILE_ATTRIBUTE_HIDDEN) {
-            newEntry.attributes |= ATTR_HIDDEN;  // Oculto
-        }
-        if (attrs & FILE_ATTRIBUTE_SYSTEM) {
-            newEntry.attributes |= ATTR_SYSTEM;  // Arquivo de sistema
-        }
-    }
-#else
-    // Para sistemas Unix/Linux - mapeia permissões POSIX para atributos FAT16
-    struct stat fileStat;
-    if (stat(sourcePath.c_str(), &fileStat) == 0) {
-        // Se o arquivo não tem permissão de escrita para o dono (chmod -w)
-        if (!(fileStat.st_mode & S_IWUSR)) {
-            newEntry.attributes |= ATTR_READ_ONLY;
-            std::cout << "Arquivo marcado como somente leitura." << std::endl;
-        }
-    }
-#endif
+    newEntry.attributes = ATTR_ARCHIVE | extraAttributes;
 
     // Define timestamps (metadados temporais)
     // FAT16 tem precisão de 2 segundos para tempo de modificação
@@ -704,19 +3042,158 @@ bool FAT16Manager::createFile(const string& sourcePath, const string& destName)
     newEntry.lastAccessDate = date;
 
     // Define o tamanho exato do arquivo
-    ifstream sizeCheck(sourcePath, ios::binary | ios::ate);
-    newEntry.fileSize = sizeCheck.tellg();
-    sizeCheck.close();
+    newEntry.fileSize = totalSize;
     
     // Aponta para o primeiro cluster da cadeia (entrada da linked list)
     // Este é o ponto de partida para ler o arquivo
     newEntry.firstClusterLow = allocatedClusters.empty() ? 0 : allocatedClusters[0];
     newEntry.firstClusterHigh = 0;  // FAT16 usa apenas os 16 bits baixos
     
-    // Persiste todas as mudanças no disco
-    saveFAT();              // Atualiza a tabela de alocação
-    saveRootDirectory();    // Atualiza o diretório raiz
+    // Persiste todas as mudanças no disco (FAT e diretório raiz)
+    // Dentro de um lote, a gravação fica para o commitBatch
+    return saveMetadata() ? FAT16_OK : FAT16_IO_ERROR;
+}
+// ============================================================================
+// API DE STATUS (libfat16)
+// ============================================================================
+// Mesmas operações do menu, mas sem escrever em cout/cerr: o resultado é um
+// FAT16Status e os dados vão para buffers do chamador. As versões que
+// imprimem (renameFile, createFile...) usam os mesmos núcleos e traduzem o
+// status para as mensagens de sempre com printStatus.
+// ============================================================================
 
-    cout << "Arquivo '" << destName << "' criado com sucesso (" << newEntry.fileSize << " bytes)." << endl;
-    return true;
-}
\ No newline at end of file
+// Valida um nome no formato 8.3 (até 8 caracteres, ponto, até 3 de extensão)
+FAT16Status FAT16Manager::validateFileName(const string& name) {
+    if (name.empty()) return FAT16_INVALID_NAME;
+
+    size_t dotPos = name.find('.');
+    if (dotPos != string::npos) {
+        string baseName = name.substr(0, dotPos);
+        string ext = name.substr(dotPos + 1);
+        if (baseName.empty() || baseName.length() > 8 || ext.length() > 3) return FAT16_INVALID_NAME;
+    } else if (name.length() > 8) {
+        return FAT16_INVALID_NAME;
+    }
+    return FAT16_OK;
+}
+
+// Mensagens de erro do modo interativo para cada status
+void FAT16Manager::printStatus(FAT16Status status, const string& name) {
+    switch (status) {
+        case FAT16_OK:
+            break;
+        case FAT16_NOT_FOUND:
+            cerr << "Erro: Arquivo '" << name << "' não encontrado." << endl;
+            break;
+        case FAT16_ALREADY_EXISTS:
+            cerr << "Erro: Já existe um arquivo com o nome '" << name << "'." << endl;
+            break;
+        case FAT16_INVALID_NAME:
+            if (name.find('.') != string::npos) {
+                cerr << "Erro: Nome inválido. Formato: até 8 caracteres.até 3 caracteres" << endl;
+            } else if (name.empty()) {
+                cerr << "Erro: Nome de arquivo vazio." << endl;
+            } else {
+                cerr << "Erro: Nome muito longo (máximo 8 caracteres sem extensão)." << endl;
+            }
+            break;
+        case FAT16_DISK_FULL:
+            cerr << "Erro: Não há espaço suficiente no disco." << endl;
+            break;
+        case FAT16_DIRECTORY_FULL:
+            cerr << "Erro: Diretório raiz está cheio." << endl;
+            break;
+        default:
+            cerr << "Erro: " << statusMessage(status) << " ('" << name << "')." << endl;
+            break;
+    }
+}
+
+const char* FAT16Manager::statusMessage(FAT16Status status) {
+    switch (status) {
+        case FAT16_OK:               return "Sucesso";
+        case FAT16_NOT_FOUND:        return "Arquivo não encontrado";
+        case FAT16_ALREADY_EXISTS:   return "Já existe um arquivo com este nome";
+        case FAT16_INVALID_NAME:     return "Nome inválido (formato 8.3)";
+        case FAT16_DISK_FULL:        return "Não há espaço suficiente no disco";
+        case FAT16_DIRECTORY_FULL:   return "Diretório raiz está cheio";
+        case FAT16_BUFFER_TOO_SMALL: return "Buffer menor que o necessário";
+        case FAT16_IO_ERROR:         return "Falha de leitura/escrita na imagem ou na origem dos dados";
+        case FAT16_CORRUPTED:        return "Estruturas do sistema de arquivos inválidas";
+        case FAT16_INVALID_ARGUMENT: return "Argumento inválido";
+        default:                     return "Status desconhecido";
+    }
+}
+
+// Lê o arquivo inteiro para buffer; size recebe o tamanho do arquivo
+// mesmo quando a capacidade não é suficiente
+FAT16Status FAT16Manager::readFileInto(const string& fileName, char* buffer, size_t capacity, size_t& size) {
+    TraceGuard trace(*this, TRACE_READ_FILE, fileName);
+    size = 0;
+    DirectoryEntry* entry = findFileEntry(fileName);
+    if (!entry) return FAT16_NOT_FOUND;
+
+    size = entry->fileSize;
+    if (capacity < size) return FAT16_BUFFER_TOO_SMALL;
+    if (!buffer && size > 0) return FAT16_INVALID_ARGUMENT;
+
+    FAT16Status status = readFileCore(*entry, buffer);
+    trace.ok = (status == FAT16_OK);
+    return status;
+}
+
+FAT16Status FAT16Manager::statFile(const string& fileName, DirectoryEntry& info) {
+    TraceGuard trace(*this, TRACE_GET_FILE_INFO, fileName);
+    DirectoryEntry* entry = findFileEntry(fileName);
+    if (!entry) return FAT16_NOT_FOUND;
+
+    info = *entry;
+    trace.ok = true;
+    return FAT16_OK;
+}
+
+FAT16Status FAT16Manager::writeFile(const string& fileName, const char* data, size_t size) {
+    string sizeArg = to_string(size);
+    TraceGuard trace(*this, TRACE_CREATE_FROM_BUFFER, fileName, sizeArg);
+    if (size > 0xFFFFFFFFull || (!data && size > 0)) return FAT16_INVALID_ARGUMENT;
+
+    istringstream source(string(data ? data : "", size));
+    FAT16Status status = createFileCore(source, static_cast<uint32_t>(size), fileName, 0);
+    trace.ok = (status == FAT16_OK);
+    return status;
+}
+
+FAT16Status FAT16Manager::removeFile(const string& fileName) {
+    TraceGuard trace(*this, TRACE_DELETE_FILE, fileName);
+    DirectoryEntry* entry = findFileEntry(fileName);
+    if (!entry) return FAT16_NOT_FOUND;
+
+    uint64_t released;
+    FAT16Status status = removeFileEntry(*entry, released);
+    trace.ok = (status == FAT16_OK);
+    return status;
+}
+
+FAT16Status FAT16Manager::moveFile(const string& oldName, const string& newName) {
+    TraceGuard trace(*this, TRACE_RENAME_FILE, oldName, newName);
+    FAT16Status status = renameFileCore(oldName, newName);
+    trace.ok = (status == FAT16_OK);
+    return status;
+}
+
+// Copia até capacity entradas; count recebe o total de arquivos válidos
+FAT16Status FAT16Manager::listEntries(DirectoryEntry* entries, size_t capacity, size_t& count) {
+    TraceGuard trace(*this, TRACE_GET_FILE_ENTRIES);
+    vector<DirectoryEntry> all = collectFileEntries();
+    count = all.size();
+    if (!entries && capacity > 0) return FAT16_INVALID_ARGUMENT;
+
+    size_t copied = min(capacity, all.size());
+    if (copied > 0) {
+        memcpy(entries, all.data(), copied * sizeof(DirectoryEntry));
+    }
+    if (copied < all.size()) return FAT16_BUFFER_TOO_SMALL;
+
+    trace.ok = true;
+    return FAT16_OK;
+}
@@ -8,6 +8,16 @@
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <chrono>
+#include <functional>
+#include <ctime>
+#include "trace.h"
+#include "buffer_pool.h"
+#include "async_io.h"
+#include "fat16_status.h"
+
+// Resultado das operações da API sem saída no console
+typedef fat16_status FAT16Status;
 
 // O pragma pack é usado para garantir que as estruturas sejam alinhadas byte a byte
 // Isso é crucial para ler corretamente os dados binários do sistema de arquivos FAT16
@@ -56,6 +66,16 @@ struct DirectoryEntry {
 };
 #pragma pack(pop)
 
+// Cabeçalho do arquivo delta do modo overlay (copy-on-write)
+#define DELTA_MAGIC "F16DELTA"
+#pragma pack(push, 1)
+struct DeltaHeader {
+    char     magic[8];             // "F16DELTA"
+    uint16_t bytesPerSector;       // Deve coincidir com a imagem base
+    uint32_t totalSectors;         // Deve coincidir com a imagem base
+};
+#pragma pack(pop)
+
 // Atributos de arquivo
 #define ATTR_READ_ONLY  0x01
 #define ATTR_HIDDEN     0x02
@@ -70,6 +90,48 @@ struct DirectoryEntry {
 #define FAT_BAD_CLUSTER     0xFFF7
 #define FAT_EOF_MARKER      0xFFF8  // Qualquer valor >= 0xFFF8 indica EOF
 
+// Geometria de uma imagem nova (formatação)
+struct FormatOptions {
+    uint64_t totalBytes;           // Tamanho total da imagem
+    uint8_t  sectorsPerCluster;    // Potência de 2 entre 1 e 128
+    uint16_t rootEntryCount;       // Múltiplo de 16 (entradas por setor de 512 bytes)
+    uint8_t  numFATs;              // Cópias da FAT (1 ou 2, normalmente)
+    std::string volumeLabel;       // Até 11 caracteres (vazio = sem rótulo)
+};
+
+// Resultado da leitura assíncrona de uma cadeia (readChainAsync)
+enum AsyncReadResult {
+    ASYNC_READ_FALLBACK,           // Motor falhou antes de entregar qualquer byte: refazer síncrono
+    ASYNC_READ_DONE,               // Conteúdo inteiro entregue
+    ASYNC_READ_SHORT_CHAIN,        // Cadeia mais curta que o tamanho declarado (arquivo corrompido)
+    ASYNC_READ_IO_ERROR            // Motor falhou depois de entregar parte do conteúdo
+};
+
+// Formato da saída de listFiles e showFileAttributes
+enum OutputFormat {
+    OUTPUT_TEXT,                   // Tabela para leitura humana (padrão)
+    OUTPUT_JSON,
+    OUTPUT_CSV
+};
+
+// Resultado de checkFATCopies (verificação das cópias da FAT)
+struct FATCheckReport {
+    uint32_t numFATs = 0;
+    uint32_t reference = 0;                 // Cópia com menos erros de cadeia
+    std::vector<uint32_t> chainErrors;      // Erros de cadeia de cada cópia
+    std::vector<uint32_t> divergentSectors; // Setores da FAT em que as cópias diferem
+    uint32_t rewrittenSectors = 0;
+    bool repaired = false;
+    bool repairRefused = false;             // Nenhuma cópia válida e reparo sem force
+    int unreadableCopy = -1;                // Cópia cuja leitura falhou
+};
+
+// Resultado da busca de conteúdo: arquivo e offsets (em bytes) de cada ocorrência
+struct SearchResult {
+    std::string fileName;
+    std::vector<uint32_t> offsets;
+};
+
 // Classe para gerenciar o sistema de arquivos FAT16
 class FAT16Manager {
 private:
@@ -84,21 +146,123 @@ private:
     uint32_t dataStartSector;
     uint32_t rootDirSectors;
     
+    // Modo overlay: base somente leitura + delta esparso com os setores modificados
+    std::string deltaFileName;
+    std::fstream deltaFile;
+    std::vector<uint8_t> deltaBitmap;   // 1 bit por setor: 1 = setor está no delta
+    uint64_t deltaDataOffset;
+    
+    // Modo discard: clusters liberados são devolvidos ao host (fallocate PUNCH_HOLE)
+    bool discardEnabled;
+    int discardFd;
+    
+    // Modo direto (O_DIRECT): clusters de dados lidos/gravados sem o page cache,
+    // sempre por buffers alinhados do pool (um cluster cada)
+    int directFd;
+    AlignedBufferPool bufferPool;
+    
+    // I/O assíncrono: clusters de um arquivo submetidos em lote (io_uring ou pool)
+    AsyncIOEngine asyncIO;
+    
+    // Compactação automática do diretório raiz (0 = desativada)
+    unsigned autoCompactPercent;
+    
+    // Verificação das cópias da FAT durante a montagem e o seu resultado
+    bool verifyFATOnMount;
+    FAT16Status mountFATStatus;
+    FATCheckReport mountFATReport;
+    
+    // Formato de listFiles/showFileAttributes
+    OutputFormat outputFormat;
+    
+    // Data de último acesso (estilo relatime): marcada em memória nas leituras e
+    // gravada depois, só nos setores do diretório raiz que mudaram
+    bool accessTimeEnabled;
+    unsigned accessFlushSeconds;                // 0 = só na desmontagem
+    std::vector<bool> dirtyRootSectors;
+    std::chrono::steady_clock::time_point lastAccessFlush;
+    
+    // Lote de operações: FAT e diretório raiz só são gravados no commitBatch
+    unsigned batchDepth;
+    bool batchDirty;
+    std::vector<uint16_t> batchFreedClusters;   // Devolvidos ao host só após o commit
+    
+    // Gravação de trace (registra cada chamada pública com argumentos e tempos)
+    std::ofstream traceFile;
+    std::chrono::steady_clock::time_point traceStart;
+    int traceDepth;                 // Chamadas rastreadas em andamento (aninhadas não são gravadas)
+    friend class TraceGuard;
+    
     bool loadBootSector();
     bool loadFAT();
     bool loadRootDirectory();
-    void saveFAT();
-    void saveRootDirectory();
+    bool saveFAT();
+    bool saveRootDirectory();
+    bool saveRootDirectorySectors(uint32_t firstSector, uint32_t sectorCount);
+    bool saveMetadata();
+    void markAccessed(DirectoryEntry& entry);
+    void flushAccessTimes();
+    uint32_t validateFATChains(const uint16_t* table, size_t entries) const;
+    
+    // Camada de I/O: todo acesso a setores da imagem passa por aqui
+    bool readBytes(uint64_t offset, char* buffer, uint32_t length);
+    bool readBytesFrom(std::istream& base, std::istream* delta, uint64_t offset, char* buffer,
+                       uint32_t length) const;
+    bool writeBytes(uint64_t offset, const char* buffer, uint32_t length);
+    bool writeChangedSectors(uint64_t offset, const char* buffer, uint32_t length);
+    bool flushImage();
+    uint32_t getTotalSectors() const;
+    
+    bool openOverlay();
+    bool writeOverlayHeader();
+    bool resetOverlay();
+    bool isSectorInDelta(uint64_t sector) const;
     
-    uint32_t getClusterOffset(uint16_t cluster);
-    std::string getFileName(const DirectoryEntry& entry);
+    bool punchHole(uint64_t offset, uint64_t length);
+    uint64_t releaseClusters(std::vector<uint16_t> clusters);
+    
+    uint32_t getClusterOffset(uint16_t cluster) const;
+    bool readCluster(uint16_t cluster, char* buffer);
+    bool writeCluster(uint16_t cluster, const char* buffer);
+    AsyncReadResult readChainAsync(const DirectoryEntry& entry, const std::function<void(const char*, uint32_t)>& consume);
+    bool writeChainAsync(std::istream& source, const std::vector<uint16_t>& clusters, uint32_t fileSize,
+                         uint32_t& copied);
     void setFileName(DirectoryEntry& entry, const std::string& name);
     std::string formatDate(uint16_t date);
     std::string formatTime(uint16_t time);
+    static void toFATDateTime(time_t moment, uint16_t& date, uint16_t& time);
+    
+    bool createFileFromStream(std::istream& source, uint32_t fileSize, const std::string& destName,
+                              uint8_t extraAttributes);
+    
+    // Núcleos sem saída no console: as versões que imprimem e a API de
+    // status (readFileInto, writeFile, ...) passam por eles
+    FAT16Status mountImage(std::string& failure);
+    FAT16Status createFileCore(std::istream& source, uint32_t fileSize, const std::string& destName,
+                               uint8_t extraAttributes);
+    FAT16Status renameFileCore(const std::string& oldName, const std::string& newName);
+    FAT16Status readFileCore(DirectoryEntry& entry, char* buffer);
+    static FAT16Status validateFileName(const std::string& name);
+    static void printStatus(FAT16Status status, const std::string& name);
+    static void printFATCheckReport(FAT16Status status, const FATCheckReport& report);
+    static uint8_t hostFileAttributes(const std::string& sourcePath);
+    void chainStats(const DirectoryEntry& entry, uint32_t& clusters, uint32_t& fragments) const;
+    FAT16Status removeFileEntry(DirectoryEntry& entry, uint64_t& released);
     
     uint16_t findFreeCluster();
     DirectoryEntry* findFileEntry(const std::string& fileName);
     int findFreeDirectoryEntry();
+    std::vector<DirectoryEntry> collectFileEntries() const;
+    void forEachFileParallel(size_t count, unsigned threads,
+                             const std::function<void(size_t, std::istream&, std::istream*)>& work);
+    bool readFileExtents(const DirectoryEntry& entry, std::istream& base, std::istream* delta,
+                         std::vector<char>& buffer, uint32_t headroom,
+                         const std::function<void(uint32_t, uint32_t)>& consume) const;
+    bool computeFileChecksum(const DirectoryEntry& entry, std::istream& base, std::istream* delta,
+                             uint32_t& crc) const;
+    void searchFileContent(const DirectoryEntry& entry, const std::string& pattern,
+                           std::istream& base, std::istream* delta, std::vector<uint32_t>& matches) const;
+    void autoCompactRootDirectory();
     
 public:
     FAT16Manager(const std::string& imagePath);
@@ -111,6 +275,105 @@ public:
     bool renameFile(const std::string& oldName, const std::string& newName);
     bool deleteFile(const std::string& fileName);
     bool createFile(const std::string& sourcePath, const std::string& destName);
+    
+    // Atualização da data de último acesso nas leituras (ativa por padrão).
+    // flushSeconds > 0 grava as datas pendentes a cada intervalo; senão, na desmontagem
+    void setAccessTimeMode(bool enabled, unsigned flushSeconds = 0);
+    void flushAccessTimesIfDue();
+    
+    // Saída estruturada (JSON/CSV) de listFiles e showFileAttributes, com
+    // número de clusters e de fragmentos de cada arquivo
+    void setOutputFormat(OutputFormat format);
+    
+    // API sem saída no console (biblioteca libfat16 e modo servidor): cada
+    // operação devolve um FAT16Status; conteúdo e listagem vão para buffers
+    // do chamador. Com capacidade insuficiente, readFileInto/listEntries
+    // informam o tamanho necessário e devolvem FAT16_BUFFER_TOO_SMALL
+    FAT16Status mount();
+    FAT16Status readFileInto(const std::string& fileName, char* buffer, size_t capacity, size_t& size);
+    FAT16Status statFile(const std::string& fileName, DirectoryEntry& info);
+    FAT16Status writeFile(const std::string& fileName, const char* data, size_t size);
+    FAT16Status removeFile(const std::string& fileName);
+    FAT16Status moveFile(const std::string& oldName, const std::string& newName);
+    FAT16Status listEntries(DirectoryEntry* entries, size_t capacity, size_t& count);
+    static const char* statusMessage(FAT16Status status);
+    
+    // Acesso aos dados sem saída no console (usado pelo modo servidor)
+    bool readFile(const std::string& fileName, std::vector<char>& data);
+    bool getFileInfo(const std::string& fileName, DirectoryEntry& info);
+    std::vector<DirectoryEntry> getFileEntries();
+    bool createFileFromBuffer(const std::string& destName, const char* data, uint32_t size);
+    static std::string getFileName(const DirectoryEntry& entry);
+    static time_t fromFATDateTime(uint16_t date, uint16_t time);
+    
+    // Modo overlay (copy-on-write): chamar enableOverlay antes de initialize
+    void enableOverlay(const std::string& deltaPath);
+    bool isOverlayEnabled() const;
+    bool mergeOverlay();
+    bool discardOverlay();
+    
+    // Modo discard: deleteFile libera o espaço dos clusters na imagem esparsa
+    // e createFile não grava clusters totalmente zerados
+    bool setDiscardMode(bool enabled);
+    
+    // Modo direto: dados dos clusters não passam pelo page cache (Linux, O_DIRECT).
+    // Não pode ser usado com overlay
+    bool setDirectIO(bool enabled);
+    
+    // I/O assíncrono dos clusters de dados com até queueDepth operações em voo:
+    // io_uring quando o kernel permite, senão pool de threads com pread/pwrite.
+    // Respeita o modo direto ativo no momento da chamada; não pode ser usado com overlay
+    bool setAsyncIO(bool enabled, unsigned queueDepth = 32);
+    
+    // Compactação do diretório raiz: remove entradas apagadas (0xE5) e
+    // recoloca o marcador de fim (0x00) logo após as entradas válidas
+    int compactRootDirectory();
+    void setAutoCompact(unsigned tombstonePercent);
+    
+    // Busca um padrão de bytes no conteúdo de todos os arquivos do diretório raiz,
+    // distribuindo os arquivos entre threads (0 = número de núcleos)
+    std::vector<SearchResult> searchContent(const std::string& pattern, unsigned threads = 0);
+    
+    // Manifesto de integridade com CRC32C de cada arquivo (calculado em paralelo)
+    bool writeChecksumManifest(const std::string& manifestPath, unsigned threads = 0);
+    int verifyChecksumManifest(const std::string& manifestPath, unsigned threads = 0);
+    
+    // Compara as numFATs cópias da FAT e, com repair, regrava só os setores
+    // divergentes a partir da cópia que passa na validação de cadeias (com
+    // force, a partir da que tem menos erros, mesmo que nenhuma passe).
+    // checkFATCopies não escreve no console; verifyFATCopies mostra o relatório
+    FAT16Status checkFATCopies(bool repair, bool force, FATCheckReport& report);
+    bool verifyFATCopies(bool repair, bool force = false);
+    
+    // Com a verificação na montagem, mount/initialize reparam as cópias
+    // divergentes quando há uma referência válida (nunca com force).
+    // initialize mostra o relatório; pela API ele fica em mountFATCheck
+    void setVerifyFATOnMount(bool enabled);
+    FAT16Status mountFATCheck(FATCheckReport& report) const;
+    
+    // Lote: createFile/deleteFile dentro de beginBatch/commitBatch alteram FAT e
+    // diretório só em memória; commitBatch grava os metadados uma única vez
+    void beginBatch();
+    bool commitBatch();
+    
+    // Exporta todos os arquivos do diretório raiz como um fluxo tar (ustar) e
+    // importa um fluxo tar (um único commit de metadados no final).
+    // importTar retorna o número de arquivos importados ou -1 se o fluxo for inválido
+    bool exportTar(std::ostream& out);
+    int importTar(std::istream& in);
+    
+    // Sincroniza o diretório raiz com os arquivos regulares de hostDir: cria,
+    // substitui ou apaga só o que difere (nome, tamanho, data/hora de modificação
+    // e, com compareContent, o CRC32C do conteúdo), num único lote.
+    // Retorna o número de alterações ou -1 em caso de erro
+    int syncFromDirectory(const std::string& hostDir, bool compareContent);
+    
+    // Cria uma imagem FAT16 nova e vazia em imagePath (arquivo esparso)
+    static bool formatImage(const std::string& imagePath, const FormatOptions& options);
+    
+    // Modo de gravação: todas as chamadas públicas seguintes são registradas em tracePath
+    bool startTrace(const std::string& tracePath);
+    void stopTrace();
 };
 
 #endif // FAT16_H
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "fat16_c.h"
+#include "fat16.h"
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// O handle opaco da ABI em C é só um FAT16Manager
+struct fat16_image {
+    FAT16Manager manager;
+    explicit fat16_image(const string& path) : manager(path) {}
+};
+
+static void fillInfo(const DirectoryEntry& entry, fat16_file_info* info) {
+    memset(info, 0, sizeof(*info));
+    string name = FAT16Manager::getFileName(entry);
+    memcpy(info->name, name.c_str(), min(name.size(), sizeof(info->name) - 1));
+    info->attributes = entry.attributes;
+    info->first_cluster = entry.firstClusterLow;
+    info->size = entry.fileSize;
+    info->created = FAT16Manager::fromFATDateTime(entry.creationDate, entry.creationTime);
+    info->modified = FAT16Manager::fromFATDateTime(entry.lastModifiedDate, entry.lastModifiedTime);
+}
+
+// Nenhuma exceção C++ (bad_alloc, por exemplo) pode atravessar a ABI em C:
+// cada função captura tudo e devolve FAT16_IO_ERROR
+extern "C" {
+
+fat16_status fat16_open(const char* path, fat16_image** image) {
+    if (!path || !image) return FAT16_INVALID_ARGUMENT;
+    *image = nullptr;
+    try {
+        fat16_image* opened = new fat16_image(path);
+        fat16_status status = opened->manager.mount();
+        if (status != FAT16_OK) {
+            delete opened;
+            return status;
+        }
+        *image = opened;
+        return FAT16_OK;
+    } catch (...) {
+        return FAT16_IO_ERROR;
+    }
+}
+
+void fat16_close(fat16_image* image) {
+    try {
+        delete image;
+    } catch (...) {
+    }
+}
+
+fat16_status fat16_read(fat16_image* image, const char* name, void* buffer, size_t capacity, size_t* size) {
+    if (!image || !name || !size) return FAT16_INVALID_ARGUMENT;
+    try {
+        return image->manager.readFileInto(name, static_cast<char*>(buffer), capacity, *size);
+    } catch (...) {
+        return FAT16_IO_ERROR;
+    }
+}
+
+fat16_status fat16_stat(fat16_image* image, const char* name, fat16_file_info* info) {
+    if (!image || !name || !info) return FAT16_INVALID_ARGUMENT;
+    try {
+        DirectoryEntry entry;
+        fat16_status status = image->manager.statFile(name, entry);
+        if (status == FAT16_OK) fillInfo(entry, info);
+        return status;
+    } catch (...) {
+        return FAT16_IO_ERROR;
+    }
+}
+
+fat16_status fat16_write(fat16_image* image, const char* name, const void* data, size_t size) {
+    if (!image || !name) return FAT16_INVALID_ARGUMENT;
+    try {
+        return image->manager.writeFile(name, static_cast<const char*>(data), size);
+    } catch (...) {
+        return FAT16_IO_ERROR;
+    }
+}
+
+fat16_status fat16_delete(fat16_image* image, const char* name) {
+    if (!image || !name) return FAT16_INVALID_ARGUMENT;
+    try {
+        return image->manager.removeFile(name);
+    } catch (...) {
+        return FAT16_IO_ERROR;
+    }
+}
+
+fat16_status fat16_rename(fat16_image* image, const char* old_name, const char* new_name) {
+    if (!image || !old_name || !new_name) return FAT16_INVALID_ARGUMENT;
+    try {
+        return image->manager.moveFile(old_name, new_name);
+    } catch (...) {
+        return FAT16_IO_ERROR;
+    }
+}
+
+fat16_status fat16_list(fat16_image* image, fat16_file_info* entries, size_t capacity, size_t* count) {
+    if (!image || !count || (!entries && capacity > 0)) return FAT16_INVALID_ARGUMENT;
+    try {
+        vector<DirectoryEntry> found(capacity);
+        fat16_status status = image->manager.listEntries(found.data(), capacity, *count);
+        for (size_t i = 0; i < capacity && i < *count; i++) {
+            fillInfo(found[i], &entries[i]);
+        }
+        return status;
+    } catch (...) {
+        return FAT16_IO_ERROR;
+    }
+}
+
+const char* fat16_status_string(fat16_status status) {
+    return FAT16Manager::statusMessage(status);
+}
+
+}
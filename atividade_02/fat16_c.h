@@ -0,0 +1,49 @@
+#ifndef FAT16_C_H
+#define FAT16_C_H
+
+/* ABI em C da libfat16: acesso a uma imagem FAT16 sem saída no console.
+ * Todas as funções devolvem um fat16_status; nenhuma exceção atravessa a
+ * fronteira. Um fat16_image não deve ser usado por duas threads ao mesmo tempo. */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fat16_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct fat16_image fat16_image;
+
+/* Metadados de um arquivo do diretório raiz */
+typedef struct fat16_file_info {
+    char     name[13];             /* "NOME.EXT" terminado em '\0' */
+    uint8_t  attributes;           /* Bits ATTR_* do FAT16 */
+    uint16_t first_cluster;
+    uint32_t size;                 /* Bytes */
+    int64_t  created;              /* time_t local (precisão de 2 s) */
+    int64_t  modified;
+} fat16_file_info;
+
+/* Monta a imagem; em caso de sucesso *image deve ser liberada com fat16_close */
+fat16_status fat16_open(const char* path, fat16_image** image);
+void fat16_close(fat16_image* image);
+
+/* Lê o arquivo inteiro; *size recebe o tamanho mesmo com FAT16_BUFFER_TOO_SMALL */
+fat16_status fat16_read(fat16_image* image, const char* name, void* buffer, size_t capacity, size_t* size);
+fat16_status fat16_stat(fat16_image* image, const char* name, fat16_file_info* info);
+fat16_status fat16_write(fat16_image* image, const char* name, const void* data, size_t size);
+fat16_status fat16_delete(fat16_image* image, const char* name);
+fat16_status fat16_rename(fat16_image* image, const char* old_name, const char* new_name);
+
+/* Preenche até capacity entradas; *count recebe o total de arquivos */
+fat16_status fat16_list(fat16_image* image, fat16_file_info* entries, size_t capacity, size_t* count);
+
+/* Descrição (UTF-8, em português) de um status */
+const char* fat16_status_string(fat16_status status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FAT16_C_H */
@@ -0,0 +1,19 @@
+#ifndef FAT16_STATUS_H
+#define FAT16_STATUS_H
+
+/* Códigos de resultado da API sem saída no console.
+ * Compartilhado entre a classe C++ (FAT16Status) e a ABI em C (fat16_c.h). */
+typedef enum fat16_status {
+    FAT16_OK               = 0,
+    FAT16_NOT_FOUND        = 1,    /* Arquivo não existe no diretório raiz */
+    FAT16_ALREADY_EXISTS   = 2,    /* Nome de destino já usado */
+    FAT16_INVALID_NAME     = 3,    /* Fora do formato 8.3 */
+    FAT16_DISK_FULL        = 4,    /* Sem clusters livres suficientes */
+    FAT16_DIRECTORY_FULL   = 5,    /* Sem entradas livres no diretório raiz */
+    FAT16_BUFFER_TOO_SMALL = 6,    /* Buffer do chamador menor que o necessário */
+    FAT16_IO_ERROR         = 7,    /* Falha de leitura/escrita na imagem ou na origem */
+    FAT16_CORRUPTED        = 8,    /* Estruturas inválidas (boot sector, cadeia curta) */
+    FAT16_INVALID_ARGUMENT = 9
+} fat16_status;
+
+#endif /* FAT16_STATUS_H */
@@ -1,6 +1,12 @@
 #include "fat16.h"
+#include "server.h"
+#include "bench.h"
 #include <iostream>
 #include <limits>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 using namespace std;
 
 void clearInputBuffer() {
@@ -23,13 +29,173 @@ void showMenu() {
     cout << "Escolha uma opçao: ";
 }
 
+void showUsage(const char* program) {
+    cerr << "Uso: " << program << " [--trace arquivo.trc] [--overlay delta.img] [--discard] [--auto-compact PCT] [--mount-check-fat]\n";
+    cerr << "     " << string(strlen(program), ' ') << " [--noatime | --atime-flush SEGUNDOS] [--direct] [--async-io PROFUNDIDADE] [imagem]\n";
+    cerr << "     " << program << " --overlay delta.img --merge-overlay|--discard-overlay imagem\n";
+    cerr << "     " << program << " --replay arquivo.trc imagem\n";
+    cerr << "     " << program << " --format TAMANHO_MB [--spc N] [--root-entries N] [--fats N] [--label ROTULO] [--force] imagem\n";
+    cerr << "     " << program << " --bench-geometry TAMANHO_MB imagem_temporaria\n";
+    cerr << "     " << program << " --tar-export arquivo.tar|- imagem\n";
+    cerr << "     " << program << " --tar-import arquivo.tar|- imagem\n";
+    cerr << "     " << program << " --sync diretorio [--sync-content] imagem\n";
+    cerr << "     " << program << " --list|--attributes NOME [--output texto|json|csv] imagem\n";
+    cerr << "     " << program << " --compact imagem\n";
+    cerr << "     " << program << " --check-fat|--repair-fat [--force] imagem\n";
+    cerr << "     " << program << " --search padrao imagem\n";
+    cerr << "     " << program << " --checksum|--verify imagem   (manifesto em imagem.crc)\n";
+    cerr << "     " << program << " --serve socket imagem [imagem...]\n";
+    cerr << "     " << program << " --client socket [--image N] list|read|stat|rename|delete|create [args]\n";
+}
+
 int main(int argc, char* argv[]) {
     string imagePath;
+    string tracePath;
+    string replayPath;
+    string overlayPath;
+    string overlayAction;
+    bool discard = false;
+    bool direct = false;
+    unsigned asyncDepth = 0;
+    bool compact = false;
+    string searchPattern;
+    string checksumAction;
+    string fatAction;
+    bool mountCheckFat = false;
+    int autoCompact = 0;
+    string servePath;
+    vector<string> serveImages;
+    uint32_t formatMB = 0;
+    uint32_t benchMB = 0;
+    bool force = false;
+    string tarExport;
+    string tarImport;
+    string syncDir;
+    bool syncContent = false;
+    bool list = false;
+    string attributesName;
+    OutputFormat output = OUTPUT_TEXT;
+    bool accessTime = true;
+    unsigned accessFlush = 0;
+    FormatOptions format = { 0, 4, 512, 2, "" };
+
+    // Processa as opções de linha de comando; o argumento restante é a imagem
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if ((arg == "--trace" || arg == "--replay") && i + 1 < argc) {
+            (arg == "--trace" ? tracePath : replayPath) = argv[++i];
+        } else if (arg == "--overlay" && i + 1 < argc) {
+            overlayPath = argv[++i];
+        } else if (arg == "--serve" && i + 1 < argc) {
+            servePath = argv[++i];
+        } else if (arg == "--client" && i + 1 < argc) {
+            // Tudo após o socket pertence ao cliente
+            string socketPath = argv[++i];
+            int image = 0;
+            if (i + 2 < argc && string(argv[i + 1]) == "--image") {
+                image = atoi(argv[i + 2]);
+                i += 2;
+            }
+            return runClient(socketPath, image, vector<string>(argv + i + 1, argv + argc));
+        } else if (arg == "--format" && i + 1 < argc) {
+            formatMB = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--bench-geometry" && i + 1 < argc) {
+            benchMB = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--spc" && i + 1 < argc) {
+            format.sectorsPerCluster = static_cast<uint8_t>(atoi(argv[++i]));
+        } else if (arg == "--root-entries" && i + 1 < argc) {
+            format.rootEntryCount = static_cast<uint16_t>(atoi(argv[++i]));
+        } else if (arg == "--fats" && i + 1 < argc) {
+            format.numFATs = static_cast<uint8_t>(atoi(argv[++i]));
+        } else if (arg == "--label" && i + 1 < argc) {
+            format.volumeLabel = argv[++i];
+        } else if (arg == "--force") {
+            force = true;
+        } else if (arg == "--tar-export" && i + 1 < argc) {
+            tarExport = argv[++i];
+        } else if (arg == "--tar-import" && i + 1 < argc) {
+            tarImport = argv[++i];
+        } else if (arg == "--sync" && i + 1 < argc) {
+            syncDir = argv[++i];
+        } else if (arg == "--sync-content") {
+            syncContent = true;
+        } else if (arg == "--list") {
+            list = true;
+        } else if (arg == "--attributes" && i + 1 < argc) {
+            attributesName = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            string name = argv[++i];
+            output = name == "json" ? OUTPUT_JSON : name == "csv" ? OUTPUT_CSV : OUTPUT_TEXT;
+        } else if (arg == "--noatime") {
+            accessTime = false;
+        } else if (arg == "--atime-flush" && i + 1 < argc) {
+            accessFlush = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--search" && i + 1 < argc) {
+            searchPattern = argv[++i];
+        } else if (arg == "--checksum" || arg == "--verify") {
+            checksumAction = arg;
+        } else if (arg == "--check-fat" || arg == "--repair-fat") {
+            fatAction = arg;
+        } else if (arg == "--mount-check-fat") {
+            mountCheckFat = true;
+        } else if (arg == "--compact") {
+            compact = true;
+        } else if (arg == "--auto-compact" && i + 1 < argc) {
+            autoCompact = atoi(argv[++i]);
+        } else if (arg == "--async-io" && i + 1 < argc) {
+            asyncDepth = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--direct") {
+            direct = true;
+        } else if (arg == "--discard") {
+            discard = true;
+        } else if (arg == "--merge-overlay" || arg == "--discard-overlay") {
+            overlayAction = arg;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            showUsage(argv[0]);
+            return 1;
+        } else {
+            imagePath = arg;
+            serveImages.push_back(arg);
+        }
+    }
+
+    // Modo servidor: mantém as imagens montadas e atende via socket Unix
+    if (!servePath.empty()) {
+        if (serveImages.empty()) {
+            showUsage(argv[0]);
+            return 1;
+        }
+        return runServer(servePath, serveImages);
+    }
+
+    // Cria uma imagem nova; não sobrescreve uma existente sem --force
+    if (formatMB > 0 || benchMB > 0) {
+        if (imagePath.empty()) {
+            showUsage(argv[0]);
+            return 1;
+        }
+        if (benchMB > 0) {
+            return benchmarkGeometry(benchMB, imagePath);
+        }
+        if (!force && ifstream(imagePath).good()) {
+            cerr << "Erro: " << imagePath << " já existe (use --force para sobrescrever)." << endl;
+            return 1;
+        }
+        format.totalBytes = uint64_t(formatMB) * 1024 * 1024;
+        return FAT16Manager::formatImage(imagePath, format) ? 0 : 1;
+    }
+
+    // Modo replay: reexecuta um trace gravado sobre uma cópia da imagem
+    if (!replayPath.empty()) {
+        if (imagePath.empty()) {
+            showUsage(argv[0]);
+            return 1;
+        }
+        return replayTrace(replayPath, imagePath);
+    }
 
     // Verificar se o caminho da imagem foi fornecido como argumento
-    if (argc > 1) {
-        imagePath = argv[1];
-    } else {
+    if (imagePath.empty()) {
         cout << "Digite o caminho para a imagem do disco FAT16: ";
         getline(cin, imagePath);
     }
@@ -37,12 +203,140 @@ int main(int argc, char* argv[]) {
     // Criar gerenciador FAT16
     FAT16Manager fat16(imagePath);
     
+    // Verificação (e reparo) das cópias da FAT durante a montagem
+    fat16.setVerifyFATOnMount(mountCheckFat);
+    
+    // Datas de último acesso: gravadas em lote (periodicamente ou ao sair)
+    fat16.setAccessTimeMode(accessTime, accessFlush);
+    
+    // Compactação automática do diretório raiz: vale também para os modos de
+    // execução única (--sync, --tar-import...), não só para o menu
+    if (autoCompact > 0) {
+        fat16.setAutoCompact(autoCompact);
+    }
+    
+    // Modo overlay: a imagem base fica intacta e as escritas vão para o delta
+    if (!overlayPath.empty()) {
+        fat16.enableOverlay(overlayPath);
+    } else if (!overlayAction.empty()) {
+        showUsage(argv[0]);
+        return 1;
+    }
+    
+    // Modo de gravação: registra todas as operações desta sessão
+    if (!tracePath.empty() && !fat16.startTrace(tracePath)) {
+        return 1;
+    }
+    
     // Inicializar
     if (!fat16.initialize()) {
         cerr << "\nFalha ao inicializar o sistema de arquivos FAT16." << endl;
         return 1;
     }
 
+    // Modo discard: espaço de clusters liberados volta para o host
+    if (discard && !fat16.setDiscardMode(true)) {
+        return 1;
+    }
+
+    // Modo direto: dados dos clusters sem passar pelo page cache
+    if (direct && !fat16.setDirectIO(true)) {
+        return 1;
+    }
+
+    // I/O assíncrono: clusters de cada arquivo em lotes de até asyncDepth operações
+    if (asyncDepth > 0 && !fat16.setAsyncIO(true, asyncDepth)) {
+        return 1;
+    }
+
+    // Busca o padrão em todos os arquivos e encerra
+    if (!searchPattern.empty()) {
+        vector<SearchResult> results = fat16.searchContent(searchPattern);
+        for (const SearchResult& result : results) {
+            cout << result.fileName << ":";
+            for (uint32_t offset : result.offsets) {
+                cout << " " << offset;
+            }
+            cout << "\n";
+        }
+        cout << results.size() << " arquivo(s) contém o padrão." << endl;
+        return 0;
+    }
+
+    // Exporta/importa todos os arquivos como fluxo tar ("-" = stdout/stdin)
+    if (!tarExport.empty()) {
+        if (tarExport == "-") {
+            // stdout recebe só o tar: mensagens do gerenciador são descartadas
+            ostream out(cout.rdbuf());
+            NullBuffer nullBuffer;
+            cout.rdbuf(&nullBuffer);
+            bool ok = fat16.exportTar(out);
+            cout.rdbuf(out.rdbuf());
+            return ok ? 0 : 1;
+        }
+        ofstream out(tarExport, ios::binary | ios::trunc);
+        if (!out.is_open()) {
+            cerr << "Erro: Não foi possível criar " << tarExport << endl;
+            return 1;
+        }
+        return fat16.exportTar(out) ? 0 : 1;
+    }
+    if (!tarImport.empty()) {
+        if (tarImport == "-") {
+            return fat16.importTar(cin) >= 0 ? 0 : 1;
+        }
+        ifstream in(tarImport, ios::binary);
+        if (!in.is_open()) {
+            cerr << "Erro: Não foi possível abrir " << tarImport << endl;
+            return 1;
+        }
+        return fat16.importTar(in) >= 0 ? 0 : 1;
+    }
+
+    // Listagem/atributos para ferramentas (também vale para o menu interativo)
+    fat16.setOutputFormat(output);
+    if (list) {
+        fat16.listFiles();
+        return 0;
+    }
+    if (!attributesName.empty()) {
+        fat16.showFileAttributes(attributesName);
+        return 0;
+    }
+
+    // Atualiza a imagem com o conteúdo de um diretório do host
+    if (!syncDir.empty()) {
+        return fat16.syncFromDirectory(syncDir, syncContent) >= 0 ? 0 : 1;
+    }
+
+    // Gera ou confere o manifesto de integridade (arquivo .crc ao lado da imagem)
+    if (checksumAction == "--checksum") {
+        return fat16.writeChecksumManifest(imagePath + ".crc") ? 0 : 1;
+    }
+    if (checksumAction == "--verify") {
+        return fat16.verifyChecksumManifest(imagePath + ".crc") == 0 ? 0 : 1;
+    }
+
+    // Verifica ou repara as cópias da FAT e encerra
+    if (!fatAction.empty()) {
+        return fat16.verifyFATCopies(fatAction == "--repair-fat", force) ? 0 : 1;
+    }
+
+    // Compacta o diretório raiz e encerra
+    if (compact) {
+        int removed = fat16.compactRootDirectory();
+        cout << "Diretório raiz compactado: " << removed << " entradas apagadas removidas." << endl;
+        return 0;
+    }
+
+    // Consolida ou descarta o delta e encerra
+    if (overlayAction == "--merge-overlay") {
+        return fat16.mergeOverlay() ? 0 : 1;
+    }
+    if (overlayAction == "--discard-overlay") {
+        return fat16.discardOverlay() ? 0 : 1;
+    }
+
     cout << "\nSistema de arquivos FAT16 carregado com sucesso!\n";
 
     // Loop do menu
@@ -50,6 +344,8 @@ int main(int argc, char* argv[]) {
     bool running = true;
     
     while (running) {
+        // Datas de acesso pendentes há mais que --atime-flush vão para o disco
+        fat16.flushAccessTimesIfDue();
         showMenu();
 
         if (!(cin >> option)) {
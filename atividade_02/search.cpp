@@ -0,0 +1,56 @@
+#include "search.h"
+#include <cstring>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+using namespace std;
+
+// Versão escalar: memchr encontra candidatos pelo primeiro byte
+static void findAllScalar(const char* data, size_t length, const string& pattern, size_t start,
+                          uint32_t baseOffset, vector<uint32_t>& matches) {
+    size_t m = pattern.size();
+    const char* end = data + length - m + 1;
+    const char* p = data + start;
+
+    while (p < end) {
+        p = static_cast<const char*>(memchr(p, pattern[0], end - p));
+        if (!p) break;
+        if (memcmp(p, pattern.data(), m) == 0) {
+            matches.push_back(baseOffset + static_cast<uint32_t>(p - data));
+        }
+        p++;
+    }
+}
+
+void findAllMatches(const char* data, size_t length, const string& pattern,
+                    uint32_t baseOffset, vector<uint32_t>& matches) {
+    size_t m = pattern.size();
+    if (m == 0 || length < m) return;
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    // Filtro "primeiro e último byte": um candidato na posição i exige
+    // data[i] == pattern[0] e data[i + m - 1] == pattern[m - 1]
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[m - 1]);
+
+    for (; i + m - 1 + 16 <= length; i += 16) {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + m - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+                                                        _mm_cmpeq_epi8(blockLast, last)));
+        while (mask != 0) {
+            unsigned bit = __builtin_ctz(mask);
+            if (memcmp(data + i + bit + 1, pattern.data() + 1, m > 2 ? m - 2 : 0) == 0) {
+                matches.push_back(baseOffset + static_cast<uint32_t>(i + bit));
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    // Cauda (ou tudo, sem SSE2)
+    findAllScalar(data, length, pattern, i, baseOffset, matches);
+}
@@ -0,0 +1,16 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Busca todas as ocorrências (inclusive sobrepostas) de pattern em data[0, length)
+// e adiciona baseOffset + posição de cada uma em matches.
+// Usa SSE2 quando disponível: compara o primeiro e o último byte do padrão
+// em 16 posições por vez e só confirma com memcmp os candidatos que passam.
+void findAllMatches(const char* data, size_t length, const std::string& pattern,
+                    uint32_t baseOffset, std::vector<uint32_t>& matches);
+
+#endif // SEARCH_H
@@ -0,0 +1,365 @@
+#include "server.h"
+#include "fat16.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <set>
+#include <iterator>
+#include <cstring>
+
+#ifndef _WIN32
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <signal.h>
+    #include <cerrno>
+#endif
+
+using namespace std;
+
+#ifndef _WIN32
+
+// Tamanho máximo aceito para o conteúdo de um SRV_CREATE
+#define SERVER_MAX_DATA (256u * 1024u * 1024u)
+
+// Imagem montada: o FAT16Manager mantém FAT e diretório raiz em memória,
+// então cada requisição custa só a operação em si (sem reabrir/remontar).
+// O FAT16Manager não é thread-safe: cada imagem tem seu próprio mutex, e
+// clientes em imagens diferentes são atendidos em paralelo.
+struct MountedImage {
+    unique_ptr<FAT16Manager> fs;
+    mutex lock;
+};
+
+static vector<unique_ptr<MountedImage>> mountedImages;
+
+// Controle de encerramento e das conexões ativas
+static volatile sig_atomic_t stopRequested = 0;
+static mutex clientsMutex;
+static condition_variable clientsDone;
+static set<int> activeClients;
+
+static void handleStopSignal(int) {
+    stopRequested = 1;
+}
+
+static bool readAll(int fd, void* buffer, size_t length) {
+    char* p = static_cast<char*>(buffer);
+    while (length > 0) {
+        ssize_t n = recv(fd, p, length, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        length -= n;
+    }
+    return true;
+}
+
+static bool writeAll(int fd, const void* buffer, size_t length) {
+    const char* p = static_cast<const char*>(buffer);
+    while (length > 0) {
+        ssize_t n = send(fd, p, length, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        length -= n;
+    }
+    return true;
+}
+
+static bool sendResponse(int fd, int32_t status, const char* payload, uint32_t length) {
+    ServerResponseHeader response;
+    response.status = status;
+    response.payloadLen = length;
+    return writeAll(fd, &response, sizeof(response)) && writeAll(fd, payload, length);
+}
+
+// Traduz o resultado da API de status para o protocolo
+static int32_t toServerStatus(FAT16Status status) {
+    switch (status) {
+        case FAT16_OK:        return SRV_OK;
+        case FAT16_NOT_FOUND: return SRV_NOT_FOUND;
+        default:              return SRV_FAILED;
+    }
+}
+
+// Executa uma requisição sobre a imagem (com o mutex da imagem já adquirido)
+// Usa só a API de status, que não escreve no console
+static int32_t executeRequest(FAT16Manager& fs, const ServerRequestHeader& request,
+                              const string& arg1, const string& arg2,
+                              const vector<char>& data, vector<char>& payload) {
+    switch (request.op) {
+        case SRV_LIST: {
+            // Primeira chamada só descobre quantas entradas existem
+            size_t count = 0;
+            FAT16Status status = fs.listEntries(nullptr, 0, count);
+            if (status == FAT16_BUFFER_TOO_SMALL) {
+                payload.resize(count * sizeof(DirectoryEntry));
+                status = fs.listEntries(reinterpret_cast<DirectoryEntry*>(payload.data()), count, count);
+            }
+            return toServerStatus(status);
+        }
+        case SRV_READ: {
+            size_t size = 0;
+            FAT16Status status = fs.readFileInto(arg1, nullptr, 0, size);
+            if (status == FAT16_BUFFER_TOO_SMALL) {
+                payload.resize(size);
+                status = fs.readFileInto(arg1, payload.data(), size, size);
+            }
+            if (status != FAT16_OK) payload.clear();
+            return toServerStatus(status);
+        }
+        case SRV_STAT: {
+            DirectoryEntry entry;
+            FAT16Status status = fs.statFile(arg1, entry);
+            if (status != FAT16_OK) return toServerStatus(status);
+            payload.assign(reinterpret_cast<const char*>(&entry),
+                           reinterpret_cast<const char*>(&entry) + sizeof(entry));
+            return SRV_OK;
+        }
+        case SRV_RENAME:
+            return toServerStatus(fs.moveFile(arg1, arg2));
+        case SRV_DELETE:
+            return toServerStatus(fs.removeFile(arg1));
+        case SRV_CREATE:
+            return toServerStatus(fs.writeFile(arg1, data.data(), data.size()));
+        default:
+            return SRV_BAD_REQUEST;
+    }
+}
+
+// Atende um cliente até ele fechar a conexão (várias requisições por conexão)
+static void serveClient(int fd) {
+    ServerRequestHeader request;
+    string arg1, arg2;
+    vector<char> data, payload;
+
+    while (readAll(fd, &request, sizeof(request))) {
+        if (request.dataLen > SERVER_MAX_DATA) break;
+
+        arg1.resize(request.arg1Len);
+        arg2.resize(request.arg2Len);
+        data.resize(request.dataLen);
+        if ((request.arg1Len > 0 && !readAll(fd, &arg1[0], request.arg1Len)) ||
+            (request.arg2Len > 0 && !readAll(fd, &arg2[0], request.arg2Len)) ||
+            (request.dataLen > 0 && !readAll(fd, data.data(), request.dataLen))) {
+            break;
+        }
+
+        payload.clear();
+        int32_t status = SRV_BAD_REQUEST;
+        if (request.image < mountedImages.size()) {
+            MountedImage& image = *mountedImages[request.image];
+            lock_guard<mutex> guard(image.lock);
+            status = executeRequest(*image.fs, request, arg1, arg2, data, payload);
+        }
+
+        if (!sendResponse(fd, status, payload.data(), payload.size())) break;
+    }
+
+    // Remove do conjunto antes de fechar: o número do fd pode ser reutilizado
+    // por um novo accept() logo após o close()
+    lock_guard<mutex> guard(clientsMutex);
+    activeClients.erase(fd);
+    close(fd);
+    clientsDone.notify_all();
+}
+
+int runServer(const string& socketPath, const vector<string>& images) {
+    // Monta todas as imagens uma única vez
+    for (const string& path : images) {
+        unique_ptr<MountedImage> image(new MountedImage());
+        image->fs.reset(new FAT16Manager(path));
+        // Processo de longa duração: datas de acesso são gravadas a cada minuto
+        image->fs->setAccessTimeMode(true, 60);
+        if (!image->fs->initialize()) {
+            cerr << "Erro: Falha ao montar " << path << endl;
+            return 1;
+        }
+        mountedImages.push_back(move(image));
+    }
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (listenFd < 0 || socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "Erro: Caminho de socket inválido: " << socketPath << endl;
+        return 1;
+    }
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenFd, SOMAXCONN) != 0) {
+        cerr << "Erro: Não foi possível escutar em " << socketPath << ": " << strerror(errno) << endl;
+        close(listenFd);
+        return 1;
+    }
+
+    // Sem SA_RESTART: o sinal interrompe o accept() e encerra o laço
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleStopSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    cerr << "Servidor FAT16 escutando em " << socketPath << " (" << images.size() << " imagem(ns))" << endl;
+
+    while (!stopRequested) {
+        // Espera conexões em fatias de 1 s para gravar as datas de acesso
+        // pendentes mesmo sem novas leituras
+        pollfd waiting = { listenFd, POLLIN, 0 };
+        int ready = poll(&waiting, 1, 1000);
+        if (ready <= 0) {
+            if (ready < 0 && errno != EINTR) break;
+            for (unique_ptr<MountedImage>& image : mountedImages) {
+                lock_guard<mutex> guard(image->lock);
+                image->fs->flushAccessTimesIfDue();
+            }
+            continue;
+        }
+        int clientFd = accept(listenFd, nullptr, nullptr);
+        if (clientFd < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        {
+            lock_guard<mutex> guard(clientsMutex);
+            activeClients.insert(clientFd);
+        }
+        thread(serveClient, clientFd).detach();
+    }
+
+    // Encerramento: derruba as conexões ativas e espera as threads terminarem
+    close(listenFd);
+    unlink(socketPath.c_str());
+    {
+        unique_lock<mutex> guard(clientsMutex);
+        for (int fd : activeClients) {
+            shutdown(fd, SHUT_RDWR);
+        }
+        clientsDone.wait(guard, [] { return activeClients.empty(); });
+    }
+    mountedImages.clear();   // Destrutores fecham as imagens
+
+    cerr << "Servidor encerrado." << endl;
+    return 0;
+}
+
+// Envia uma requisição e recebe a resposta em uma conexão já aberta
+static int32_t clientRequest(int fd, uint8_t op, int image, const string& arg1, const string& arg2,
+                             const vector<char>& data, vector<char>& payload) {
+    ServerRequestHeader request;
+    request.op = op;
+    request.image = static_cast<uint8_t>(image);
+    request.arg1Len = static_cast<uint16_t>(arg1.size());
+    request.arg2Len = static_cast<uint16_t>(arg2.size());
+    request.dataLen = static_cast<uint32_t>(data.size());
+
+    ServerResponseHeader response;
+    if (!writeAll(fd, &request, sizeof(request)) || !writeAll(fd, arg1.data(), arg1.size()) ||
+        !writeAll(fd, arg2.data(), arg2.size()) || !writeAll(fd, data.data(), data.size()) ||
+        !readAll(fd, &response, sizeof(response))) {
+        return -1;
+    }
+    payload.resize(response.payloadLen);
+    if (response.payloadLen > 0 && !readAll(fd, payload.data(), response.payloadLen)) {
+        return -1;
+    }
+    return response.status;
+}
+
+int runClient(const string& socketPath, int image, const vector<string>& args) {
+    if (args.empty()) {
+        cerr << "Erro: Informe a operação (list, read, stat, rename, delete, create)." << endl;
+        return 1;
+    }
+
+    const string& command = args[0];
+    uint8_t op = 0;
+    size_t expectedArgs = 0;
+    if (command == "list")        { op = SRV_LIST;   expectedArgs = 0; }
+    else if (command == "read")   { op = SRV_READ;   expectedArgs = 1; }
+    else if (command == "stat")   { op = SRV_STAT;   expectedArgs = 1; }
+    else if (command == "rename") { op = SRV_RENAME; expectedArgs = 2; }
+    else if (command == "delete") { op = SRV_DELETE; expectedArgs = 1; }
+    else if (command == "create") { op = SRV_CREATE; expectedArgs = 2; }
+
+    if (op == 0 || args.size() != expectedArgs + 1) {
+        cerr << "Erro: Operação inválida: " << command << endl;
+        return 1;
+    }
+
+    string arg1 = args.size() > 1 ? args[1] : string();
+    string arg2 = args.size() > 2 ? args[2] : string();
+    vector<char> data, payload;
+
+    // create: o conteúdo do arquivo do host vai na própria requisição
+    if (op == SRV_CREATE) {
+        ifstream source(arg1, ios::binary);
+        if (!source.is_open()) {
+            cerr << "Erro: Não foi possível abrir o arquivo fonte: " << arg1 << endl;
+            return 1;
+        }
+        data.assign(istreambuf_iterator<char>(source), istreambuf_iterator<char>());
+        arg1 = arg2;
+        arg2.clear();
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        cerr << "Erro: Não foi possível conectar em " << socketPath << endl;
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+
+    int32_t status = clientRequest(fd, op, image, arg1, arg2, data, payload);
+    close(fd);
+
+    if (status != SRV_OK) {
+        cerr << "Erro: Operação falhou (status " << status << ")." << endl;
+        return 1;
+    }
+
+    if (op == SRV_LIST) {
+        size_t count = payload.size() / sizeof(DirectoryEntry);
+        const DirectoryEntry* entries = reinterpret_cast<const DirectoryEntry*>(payload.data());
+        for (size_t i = 0; i < count; i++) {
+            cout << left << setw(20) << FAT16Manager::getFileName(entries[i])
+                 << right << setw(15) << entries[i].fileSize << "\n";
+        }
+    } else if (op == SRV_STAT && payload.size() == sizeof(DirectoryEntry)) {
+        const DirectoryEntry* entry = reinterpret_cast<const DirectoryEntry*>(payload.data());
+        cout << FAT16Manager::getFileName(*entry) << " " << entry->fileSize << " bytes, "
+             << "cluster " << entry->firstClusterLow << ", atributos 0x"
+             << hex << int(entry->attributes) << dec << "\n";
+    } else if (op == SRV_READ) {
+        cout.write(payload.data(), payload.size());
+    }
+    cout.flush();
+    return 0;
+}
+
+#else
+
+int runServer(const string&, const vector<string>&) {
+    cerr << "Erro: Modo servidor não suportado nesta plataforma." << endl;
+    return 1;
+}
+
+int runClient(const string&, int, const vector<string>&) {
+    cerr << "Erro: Modo servidor não suportado nesta plataforma." << endl;
+    return 1;
+}
+
+#endif
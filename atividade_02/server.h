@@ -0,0 +1,58 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Protocolo binário do modo servidor (socket Unix local)
+//
+// Requisição: [ServerRequestHeader][arg1][arg2][data]
+// Resposta:   [ServerResponseHeader][payload]
+//
+// Uma conexão pode enviar várias requisições em sequência; o servidor responde
+// na mesma ordem. Respostas por operação:
+//   SRV_LIST   -> payload = N * DirectoryEntry (32 bytes cada, formato do disco)
+//   SRV_STAT   -> payload = 1 DirectoryEntry
+//   SRV_READ   -> payload = conteúdo do arquivo
+//   SRV_RENAME, SRV_DELETE, SRV_CREATE -> payload vazio
+
+enum ServerOp : uint8_t {
+    SRV_LIST   = 1,                // sem argumentos
+    SRV_READ   = 2,                // arg1 = nome
+    SRV_STAT   = 3,                // arg1 = nome
+    SRV_RENAME = 4,                // arg1 = nome atual, arg2 = novo nome
+    SRV_DELETE = 5,                // arg1 = nome
+    SRV_CREATE = 6                 // arg1 = nome, data = conteúdo
+};
+
+enum ServerStatus : int32_t {
+    SRV_OK          = 0,
+    SRV_FAILED      = 1,           // Operação recusada pelo FAT16Manager
+    SRV_BAD_REQUEST = 2,           // Operação ou índice de imagem inválido
+    SRV_NOT_FOUND   = 3            // Arquivo não encontrado
+};
+
+#pragma pack(push, 1)
+struct ServerRequestHeader {
+    uint8_t  op;                   // ServerOp
+    uint8_t  image;                // Índice da imagem montada (ordem da linha de comando)
+    uint16_t arg1Len;
+    uint16_t arg2Len;
+    uint32_t dataLen;
+};
+
+struct ServerResponseHeader {
+    int32_t  status;               // ServerStatus
+    uint32_t payloadLen;
+};
+#pragma pack(pop)
+
+// Mantém as imagens montadas e atende clientes em socketPath até SIGINT/SIGTERM
+int runServer(const std::string& socketPath, const std::vector<std::string>& images);
+
+// Cliente de linha de comando: list | read NOME | stat NOME | rename A B |
+// delete NOME | create ARQUIVO_HOST NOME
+int runClient(const std::string& socketPath, int image, const std::vector<std::string>& args);
+
+#endif // SERVER_H
@@ -0,0 +1,212 @@
+#include "trace.h"
+#include "fat16.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+using namespace std;
+
+const char* traceOpName(uint8_t op) {
+    switch (op) {
+        case TRACE_INITIALIZE:          return "initialize";
+        case TRACE_LIST_FILES:          return "listFiles";
+        case TRACE_SHOW_CONTENT:        return "showFileContent";
+        case TRACE_SHOW_ATTRIBUTES:     return "showFileAttributes";
+        case TRACE_RENAME_FILE:         return "renameFile";
+        case TRACE_DELETE_FILE:         return "deleteFile";
+        case TRACE_CREATE_FILE:         return "createFile";
+        case TRACE_READ_FILE:           return "readFile";
+        case TRACE_GET_FILE_INFO:       return "getFileInfo";
+        case TRACE_GET_FILE_ENTRIES:    return "getFileEntries";
+        case TRACE_CREATE_FROM_BUFFER:  return "createFileFromBuffer";
+        case TRACE_COMPACT_ROOT:        return "compactRootDirectory";
+        case TRACE_SEARCH_CONTENT:      return "searchContent";
+        case TRACE_WRITE_CHECKSUMS:     return "writeChecksumManifest";
+        case TRACE_VERIFY_CHECKSUMS:    return "verifyChecksumManifest";
+        case TRACE_VERIFY_FAT:          return "verifyFATCopies";
+        case TRACE_EXPORT_TAR:          return "exportTar";
+        case TRACE_IMPORT_TAR:          return "importTar";
+        case TRACE_SYNC_DIRECTORY:      return "syncFromDirectory";
+        default:                    return "desconhecida";
+    }
+}
+
+bool readTraceHeader(istream& in) {
+    TraceFileHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in.good()) return false;
+
+    return memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version >= 1 && header.version <= TRACE_VERSION;
+}
+
+bool readTraceEntry(istream& in, TraceEntry& entry) {
+    in.read(reinterpret_cast<char*>(&entry.header), sizeof(entry.header));
+    if (in.gcount() != sizeof(entry.header)) return false;
+
+    // Cada argumento tem que vir inteiro: um registro truncado é descartado
+    entry.arg1.resize(entry.header.arg1Len);
+    entry.arg2.resize(entry.header.arg2Len);
+    if (entry.header.arg1Len > 0) {
+        in.read(&entry.arg1[0], entry.header.arg1Len);
+        if (in.gcount() != entry.header.arg1Len) return false;
+    }
+    if (entry.header.arg2Len > 0) {
+        in.read(&entry.arg2[0], entry.header.arg2Len);
+        if (in.gcount() != entry.header.arg2Len) return false;
+    }
+    return true;
+}
+
+// Percentil sobre um vetor já ordenado (método nearest-rank)
+static uint64_t percentile(const vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.5);
+    if (rank == 0) rank = 1;
+    if (rank > sorted.size()) rank = sorted.size();
+    return sorted[rank - 1];
+}
+
+static void printLatencies(const char* label, vector<uint64_t> latencies) {
+    sort(latencies.begin(), latencies.end());
+    cout << left << setw(12) << label << right << fixed << setprecision(1)
+         << " p50: " << setw(9) << percentile(latencies, 50) / 1000.0 << " us"
+         << " | p90: " << setw(9) << percentile(latencies, 90) / 1000.0 << " us"
+         << " | p99: " << setw(9) << percentile(latencies, 99) / 1000.0 << " us"
+         << " | max: " << setw(9) << (latencies.empty() ? 0 : latencies.back()) / 1000.0 << " us" << endl;
+}
+
+// Copia a imagem para não alterar o original durante o replay
+static bool copyImage(const string& from, const string& to) {
+    ifstream src(from, ios::binary);
+    ofstream dst(to, ios::binary | ios::trunc);
+    if (!src.is_open() || !dst.is_open()) return false;
+    dst << src.rdbuf();
+    return dst.good();
+}
+
+int replayTrace(const string& tracePath, const string& imagePath) {
+    ifstream in(tracePath, ios::binary);
+    if (!in.is_open() || !readTraceHeader(in)) {
+        cerr << "Erro: Arquivo de trace inválido: " << tracePath << endl;
+        return 1;
+    }
+
+    vector<TraceEntry> entries;
+    TraceEntry entry;
+    while (readTraceEntry(in, entry)) {
+        entries.push_back(entry);
+    }
+
+    string replayImage = imagePath + ".replay";
+    if (!copyImage(imagePath, replayImage)) {
+        cerr << "Erro: Não foi possível copiar a imagem para " << replayImage << endl;
+        return 1;
+    }
+
+    FAT16Manager fat16(replayImage);
+    if (!fat16.initialize()) {
+        cerr << "Erro: Falha ao montar a cópia da imagem." << endl;
+        return 1;
+    }
+
+    // Silencia a saída das operações durante a medição, para que ela
+    // reflita o custo do sistema de arquivos e não o do terminal
+    NullBuffer nullBuffer;
+    streambuf* oldCout = cout.rdbuf(&nullBuffer);
+    streambuf* oldCerr = cerr.rdbuf(&nullBuffer);
+
+    // O manifesto gravado pelo trace fica ao lado da cópia: reexecutar
+    // TRACE_WRITE_CHECKSUMS com o caminho original sobrescreveria o .crc
+    // da imagem real. A conferência usa o da cópia depois que ele existir
+    string replayManifest = replayImage + ".crc";
+    bool manifestWritten = false;
+
+    vector<uint64_t> replayed, recorded;
+    vector<char> data;
+    DirectoryEntry info;
+    size_t divergent = 0;   // Operações cujo resultado (ok/falha) difere do gravado
+    map<uint8_t, size_t> skipped;   // Operações que não podem ser reexecutadas (ex.: importTar)
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+
+    for (const TraceEntry& e : entries) {
+        // A montagem já foi feita acima; initialize não é reexecutado
+        if (e.header.op == TRACE_INITIALIZE) continue;
+
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        bool ok = true;
+        switch (e.header.op) {
+            case TRACE_LIST_FILES:          fat16.listFiles(); break;
+            case TRACE_SHOW_CONTENT:        fat16.showFileContent(e.arg1); break;
+            case TRACE_SHOW_ATTRIBUTES:     fat16.showFileAttributes(e.arg1); break;
+            case TRACE_RENAME_FILE:         ok = fat16.renameFile(e.arg1, e.arg2); break;
+            case TRACE_DELETE_FILE:         ok = fat16.deleteFile(e.arg1); break;
+            case TRACE_CREATE_FILE:         ok = fat16.createFile(e.arg1, e.arg2); break;
+            case TRACE_READ_FILE:           ok = fat16.readFile(e.arg1, data); break;
+            case TRACE_GET_FILE_INFO:       ok = fat16.getFileInfo(e.arg1, info); break;
+            case TRACE_GET_FILE_ENTRIES:    fat16.getFileEntries(); break;
+            case TRACE_CREATE_FROM_BUFFER: {
+                // O conteúdo não faz parte do trace: recria com o mesmo tamanho
+                data.assign(strtoul(e.arg2.c_str(), nullptr, 10), 0);
+                ok = fat16.createFileFromBuffer(e.arg1, data.data(), data.size());
+                break;
+            }
+            case TRACE_COMPACT_ROOT:        fat16.compactRootDirectory(); break;
+            case TRACE_SEARCH_CONTENT:      fat16.searchContent(e.arg1); break;
+            case TRACE_WRITE_CHECKSUMS:
+                ok = fat16.writeChecksumManifest(replayManifest);
+                manifestWritten = manifestWritten || ok;
+                break;
+            case TRACE_VERIFY_CHECKSUMS:
+                ok = fat16.verifyChecksumManifest(manifestWritten ? replayManifest : e.arg1) == 0;
+                break;
+            case TRACE_VERIFY_FAT:          ok = fat16.verifyFATCopies(e.arg1 != "check", e.arg1 == "force"); break;
+            case TRACE_EXPORT_TAR: {
+                ostream sink(&nullBuffer);
+                ok = fat16.exportTar(sink);
+                break;
+            }
+            case TRACE_SYNC_DIRECTORY:      ok = fat16.syncFromDirectory(e.arg1, e.arg2 == "content") >= 0; break;
+            default:
+                skipped[e.header.op]++;
+                continue;
+        }
+        chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+
+        replayed.push_back(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+        recorded.push_back(e.header.durationNs);
+        if (ok != (e.header.ok != 0)) divergent++;
+    }
+
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    cout.rdbuf(oldCout);
+    cerr.rdbuf(oldCerr);
+
+    double seconds = chrono::duration<double>(end - begin).count();
+
+    cout << "\n========== REPLAY DO TRACE: " << tracePath << " ==========\n";
+    cout << "Imagem (cópia): " << replayImage << endl;
+    cout << "Operações reexecutadas: " << replayed.size() << endl;
+    cout << "Tempo total: " << fixed << setprecision(3) << seconds * 1000.0 << " ms" << endl;
+    cout << "Vazão: " << fixed << setprecision(0)
+         << (seconds > 0 ? replayed.size() / seconds : 0.0) << " ops/s" << endl;
+    if (divergent > 0) {
+        cout << "Aviso: " << divergent << " operações tiveram resultado diferente do gravado." << endl;
+    }
+    for (const auto& item : skipped) {
+        cout << "Aviso: " << item.second << " operação(ões) " << traceOpName(item.first)
+             << " não reexecutada(s) (dados de entrada fora do trace)." << endl;
+    }
+    cout << "\nLatências:" << endl;
+    printLatencies("Replay", replayed);
+    printLatencies("Gravado", recorded);
+    cout << "========================================\n" << endl;
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+#include <istream>
+#include <streambuf>
+
+// Formato binário do trace de I/O do FAT16Manager
+// Arquivo = [TraceFileHeader][TraceRecordHeader + arg1 + arg2]...
+// Cada registro guarda a operação pública chamada, seus argumentos
+// e o instante/duração da chamada (em nanossegundos desde o início do trace)
+
+#define TRACE_MAGIC   "F16TRACE"
+// Versão 1: operações 1-11. Versão 2: operações 12-19 (o formato dos
+// registros é o mesmo, então traces da versão 1 continuam legíveis)
+#define TRACE_VERSION 2
+
+// Operações públicas registradas no trace
+enum TraceOp : uint8_t {
+    TRACE_INITIALIZE         = 1,
+    TRACE_LIST_FILES         = 2,
+    TRACE_SHOW_CONTENT       = 3,
+    TRACE_SHOW_ATTRIBUTES    = 4,
+    TRACE_RENAME_FILE        = 5,
+    TRACE_DELETE_FILE        = 6,
+    TRACE_CREATE_FILE        = 7,
+    TRACE_READ_FILE          = 8,
+    TRACE_GET_FILE_INFO      = 9,
+    TRACE_GET_FILE_ENTRIES   = 10,
+    TRACE_CREATE_FROM_BUFFER = 11,    // arg2 = tamanho em decimal (conteúdo não é gravado)
+    TRACE_COMPACT_ROOT       = 12,
+    TRACE_SEARCH_CONTENT     = 13,
+    TRACE_WRITE_CHECKSUMS    = 14,    // arg1 = manifesto; no replay vai para <cópia>.crc
+    TRACE_VERIFY_CHECKSUMS   = 15,
+    TRACE_VERIFY_FAT         = 16,    // arg1 = "check", "repair" ou "force" (reparo sem cópia válida)
+    TRACE_EXPORT_TAR         = 17,
+    TRACE_IMPORT_TAR         = 18,    // O fluxo tar não é gravado: não é reexecutado
+    TRACE_SYNC_DIRECTORY     = 19     // arg1 = diretório do host, arg2 = "content" ou "metadata"
+};
+
+#pragma pack(push, 1)
+struct TraceFileHeader {
+    char     magic[8];             // "F16TRACE"
+    uint16_t version;              // Versão do formato
+};
+
+struct TraceRecordHeader {
+    uint8_t  op;                   // TraceOp
+    uint8_t  ok;                   // 1 se a operação teve sucesso
+    uint16_t arg1Len;              // Tamanho do primeiro argumento (bytes)
+    uint16_t arg2Len;              // Tamanho do segundo argumento (bytes)
+    uint64_t startNs;              // Início da chamada (ns desde o início do trace)
+    uint64_t durationNs;           // Duração da chamada (ns)
+};
+#pragma pack(pop)
+
+// Registro já decodificado
+struct TraceEntry {
+    TraceRecordHeader header;
+    std::string arg1;
+    std::string arg2;
+};
+
+// Buffer de saída que descarta tudo; usado para silenciar cout/cerr
+// nos modos não interativos (replay, servidor)
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+const char* traceOpName(uint8_t op);
+
+// Lê o cabeçalho do arquivo de trace e valida magic/versão
+bool readTraceHeader(std::istream& in);
+
+// Lê o próximo registro; retorna false no fim do arquivo ou se truncado
+bool readTraceEntry(std::istream& in, TraceEntry& entry);
+
+// Reexecuta o trace sobre uma cópia da imagem o mais rápido possível
+// e imprime vazão (ops/s) e latências (p50/p90/p99/máx)
+int replayTrace(const std::string& tracePath, const std::string& imagePath);
+
+#endif // TRACE_H